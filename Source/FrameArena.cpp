@@ -0,0 +1,127 @@
+///////////////////////////////////////////////////////////////////////////////
+// framearena.cpp
+// ==============
+// bump allocator for frame-transient data. The only synchronization
+// on the allocation path is one fetch_add on the offset; Reset() runs
+// on the main thread between frames when no worker is allocating.
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include "FrameArena.h"
+
+#include <cstdlib>
+#include <iostream>
+
+namespace
+{
+    // 1 MB covers the record phase of the stress scenes with room to
+    // spare; overflow falls back to the heap and shows in the stats
+    const size_t kArenaBytes = 1024 * 1024;
+}
+
+/***********************************************************
+ *  Instance()
+ *
+ *  Shared per-frame arena used by the render path.
+ ***********************************************************/
+FrameArena& FrameArena::Instance()
+{
+    static FrameArena instance;
+    return instance;
+}
+
+/***********************************************************
+ *  FrameArena()
+ ***********************************************************/
+FrameArena::FrameArena()
+    : m_storage(kArenaBytes),
+    m_offset(0),
+    m_allocationsThisFrame(0),
+    m_highWaterBytes(0),
+    m_overflowCount(0),
+    m_totalAllocations(0),
+    m_frames(0)
+{
+}
+
+/***********************************************************
+ *  Allocate()
+ *
+ *  One atomic offset advance on the hot path. The alignment pad
+ *  is taken pessimistically before the advance, so concurrent
+ *  allocations from worker threads never overlap.
+ ***********************************************************/
+void* FrameArena::Allocate(size_t bytes, size_t alignment)
+{
+    m_allocationsThisFrame.fetch_add(1, std::memory_order_relaxed);
+
+    // reserve enough for the worst-case alignment pad up front
+    const size_t reserved = bytes + alignment;
+    const size_t begin = m_offset.fetch_add(reserved, std::memory_order_relaxed);
+
+    if ((begin + reserved) <= m_storage.size())
+    {
+        const size_t base = reinterpret_cast<size_t>(m_storage.data()) + begin;
+        const size_t aligned = (base + alignment - 1) & ~(alignment - 1);
+        return reinterpret_cast<void*>(aligned);
+    }
+
+    // block exhausted: heap fallback, reclaimed by the next Reset()
+    void* block = std::malloc(bytes + alignment);
+    {
+        std::lock_guard<std::mutex> lock(m_overflowMutex);
+        m_overflowBlocks.push_back(block);
+        m_overflowCount++;
+    }
+    const size_t base = reinterpret_cast<size_t>(block);
+    const size_t aligned = (base + alignment - 1) & ~(alignment - 1);
+    return reinterpret_cast<void*>(aligned);
+}
+
+/***********************************************************
+ *  Reset()
+ *
+ *  Reclaims the whole block in O(1), frees any overflow blocks,
+ *  and rolls the per-frame telemetry into the running totals.
+ ***********************************************************/
+void FrameArena::Reset()
+{
+    const size_t usedBytes = m_offset.exchange(0, std::memory_order_relaxed);
+    if (usedBytes > m_highWaterBytes)
+    {
+        m_highWaterBytes =
+            (usedBytes < m_storage.size()) ? usedBytes : m_storage.size();
+    }
+
+    m_totalAllocations += m_allocationsThisFrame.exchange(0, std::memory_order_relaxed);
+    m_frames++;
+
+    if (!m_overflowBlocks.empty())
+    {
+        std::lock_guard<std::mutex> lock(m_overflowMutex);
+        for (void* block : m_overflowBlocks)
+        {
+            std::free(block);
+        }
+        m_overflowBlocks.clear();
+    }
+}
+
+/***********************************************************
+ *  DumpStats()
+ ***********************************************************/
+void FrameArena::DumpStats() const
+{
+    if (m_frames == 0)
+    {
+        return;
+    }
+
+    std::cout << "ARENA: block " << m_storage.size()
+        << " bytes, high water " << m_highWaterBytes
+        << ", allocations/frame "
+        << (static_cast<double>(m_totalAllocations) / static_cast<double>(m_frames))
+        << ", overflows " << m_overflowCount << std::endl;
+}
@@ -0,0 +1,67 @@
+///////////////////////////////////////////////////////////////////////////////
+// framearena.h
+// ============
+// bump allocator for frame-transient data. Allocation is one atomic
+// offset advance into a block reserved once at startup, so transient
+// render-path allocations never touch the global heap or its locks -
+// which matters once the multithreaded record phase has several
+// workers allocating in the same frame. Reset() at the top of each
+// frame reclaims everything at once and rolls the telemetry over.
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+class FrameArena
+{
+public:
+    // shared per-frame arena used by the render path
+    static FrameArena& Instance();
+
+    // Bump-allocates from the arena block; thread-safe (lock-free on
+    // the hot path). When the block is exhausted the allocation falls
+    // back to the heap, is counted as an overflow, and is still freed
+    // by the next Reset(), so overflow is a performance signal rather
+    // than a leak.
+    void* Allocate(size_t bytes, size_t alignment = alignof(double));
+
+    // typed convenience wrapper; memory is raw, callers placement-new
+    // anything that is not trivially constructible
+    template <typename T>
+    T* AllocateArray(size_t count)
+    {
+        return static_cast<T*>(Allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    // call once at the top of each frame: reclaims the whole block,
+    // frees any overflow blocks, and updates the telemetry
+    void Reset();
+
+    // prints block size, high-water usage, and per-frame allocations
+    void DumpStats() const;
+
+private:
+    FrameArena();
+
+    // arena block, reserved once; never grows mid-frame
+    std::vector<unsigned char> m_storage;
+    std::atomic<size_t> m_offset;
+
+    // heap-allocated overflow blocks, freed on Reset()
+    std::mutex m_overflowMutex;
+    std::vector<void*> m_overflowBlocks;
+
+    // telemetry
+    std::atomic<unsigned long long> m_allocationsThisFrame;
+    size_t m_highWaterBytes;
+    unsigned long long m_overflowCount;
+    unsigned long long m_totalAllocations;
+    unsigned long long m_frames;
+};
@@ -0,0 +1,371 @@
+///////////////////////////////////////////////////////////////////////////////
+// framecapture.cpp
+// ================
+// asynchronous frame capture pipeline. glReadPixels into a pixel pack
+// buffer returns immediately; a fence marks when the GPU has finished
+// the transfer, and the buffer is mapped only after the fence signals,
+// so the render thread never waits on the readback. File encoding and
+// disk writes happen entirely on the writer thread.
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include "FrameCapture.h"
+
+#include <GL/glew.h>
+
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+namespace
+{
+    // captures land next to the executable, numbered by the frame
+    // they were taken from
+    const char* const kCaptureFilePrefix = "capture_";
+
+    // binary PPM: three-line text header then raw RGB rows. No
+    // external image library needed, and every viewer opens it.
+    bool WritePPM(const char* filename, int width, int height,
+        const std::vector<unsigned char>& pixels)
+    {
+        FILE* file = fopen(filename, "wb");
+        if (file == nullptr)
+        {
+            return false;
+        }
+
+        fprintf(file, "P6\n%d %d\n255\n", width, height);
+
+        // GL rows run bottom-up; write them top-down
+        const size_t rowBytes = static_cast<size_t>(width) * 3;
+        for (int row = height - 1; row >= 0; --row)
+        {
+            fwrite(&pixels[static_cast<size_t>(row) * rowBytes], 1, rowBytes, file);
+        }
+
+        fclose(file);
+        return true;
+    }
+}
+
+/***********************************************************
+ *  Instance()
+ *
+ *  Shared capture pipeline used by the main loop.
+ ***********************************************************/
+FrameCapture& FrameCapture::Instance()
+{
+    static FrameCapture instance;
+    return instance;
+}
+
+/***********************************************************
+ *  FrameCapture()
+ ***********************************************************/
+FrameCapture::FrameCapture()
+{
+    m_width = 0;
+    m_height = 0;
+
+    for (int i = 0; i < kRingSize; ++i)
+    {
+        m_pboIDs[i] = 0;
+        m_syncObjects[i] = nullptr;
+        m_slotPending[i] = false;
+        m_slotFrameNumber[i] = 0;
+    }
+    m_writeSlot = 0;
+
+    m_bCaptureRequested = false;
+    m_bContinuous = false;
+    m_frameCounter = 0;
+    m_capturesIssued = 0;
+
+    m_bStopWriter = false;
+    m_framesWritten = 0;
+
+    m_bInitialized = false;
+}
+
+/***********************************************************
+ *  Initialize()
+ *
+ *  Creates the pixel-buffer ring sized for the backbuffer and
+ *  starts the writer thread. On failure the pipeline stays off
+ *  and every later call is a no-op.
+ ***********************************************************/
+bool FrameCapture::Initialize(int width, int height)
+{
+    if ((width <= 0) || (height <= 0))
+    {
+        std::cout << "FrameCapture: invalid capture size "
+            << width << "x" << height << std::endl;
+        return false;
+    }
+
+    m_width = width;
+    m_height = height;
+
+    const size_t bufferBytes =
+        static_cast<size_t>(width) * static_cast<size_t>(height) * 3;
+
+    glGenBuffers(kRingSize, m_pboIDs);
+    for (int i = 0; i < kRingSize; ++i)
+    {
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, m_pboIDs[i]);
+        glBufferData(GL_PIXEL_PACK_BUFFER, bufferBytes, nullptr, GL_STREAM_READ);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    m_bStopWriter = false;
+    m_writerThread = std::thread(&FrameCapture::WriterThreadMain, this);
+
+    m_bInitialized = true;
+    return true;
+}
+
+/***********************************************************
+ *  RequestCapture()
+ ***********************************************************/
+void FrameCapture::RequestCapture()
+{
+    m_bCaptureRequested = true;
+}
+
+/***********************************************************
+ *  SetContinuous()
+ ***********************************************************/
+void FrameCapture::SetContinuous(bool bEnabled)
+{
+    m_bContinuous = bEnabled;
+    if (bEnabled)
+    {
+        std::cout << "INFO: continuous frame capture on" << std::endl;
+    }
+}
+
+/***********************************************************
+ *  HarvestSlot()
+ *
+ *  Maps one pending buffer, hands its pixels to the writer
+ *  thread, and recycles the slot. Without bWait the slot is
+ *  only harvested when its fence already signaled, so this
+ *  never blocks on the GPU from the render loop.
+ ***********************************************************/
+void FrameCapture::HarvestSlot(int slot, bool bWait)
+{
+    if (!m_slotPending[slot])
+    {
+        return;
+    }
+
+    GLsync sync = static_cast<GLsync>(m_syncObjects[slot]);
+    const GLuint64 timeoutNs = bWait ? 1000000000ull : 0ull;
+    const GLenum waitResult = glClientWaitSync(sync, GL_SYNC_FLUSH_COMMANDS_BIT, timeoutNs);
+
+    if ((waitResult != GL_ALREADY_SIGNALED) && (waitResult != GL_CONDITION_SATISFIED))
+    {
+        // transfer still in flight; try again next frame
+        return;
+    }
+
+    glDeleteSync(sync);
+    m_syncObjects[slot] = nullptr;
+
+    const size_t bufferBytes =
+        static_cast<size_t>(m_width) * static_cast<size_t>(m_height) * 3;
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, m_pboIDs[slot]);
+    const void* mapped = glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
+    if (mapped != nullptr)
+    {
+        CaptureJob job;
+        job.width = m_width;
+        job.height = m_height;
+        job.frameNumber = m_slotFrameNumber[slot];
+        job.pixels.resize(bufferBytes);
+        std::memcpy(job.pixels.data(), mapped, bufferBytes);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+
+        {
+            std::lock_guard<std::mutex> lock(m_queueMutex);
+            m_jobQueue.push(std::move(job));
+        }
+        m_queueCondition.notify_one();
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    m_slotPending[slot] = false;
+}
+
+/***********************************************************
+ *  OnFrameRendered()
+ *
+ *  Per-frame hook from the main loop: harvests any readbacks
+ *  whose fences signaled, then issues a new async readback when
+ *  a capture was requested (or continuous recording is on).
+ ***********************************************************/
+void FrameCapture::OnFrameRendered()
+{
+    if (!m_bInitialized)
+    {
+        return;
+    }
+
+    m_frameCounter++;
+
+    // collect whatever finished; zero-timeout, never a stall
+    for (int i = 0; i < kRingSize; ++i)
+    {
+        HarvestSlot(i, false);
+    }
+
+    if (!m_bCaptureRequested && !m_bContinuous)
+    {
+        return;
+    }
+    m_bCaptureRequested = false;
+
+    // the next ring slot must be free; if all three readbacks are
+    // still in flight the disk or GPU cannot keep up - drop the
+    // frame rather than stall the render thread
+    if (m_slotPending[m_writeSlot])
+    {
+        return;
+    }
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, m_pboIDs[m_writeSlot]);
+    glReadBuffer(GL_BACK);
+    // the PBOs and WritePPM both assume tightly packed rows; the
+    // default pack alignment of 4 would pad rows at any framebuffer
+    // width not divisible by 4 and overflow the exact-sized buffer
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, m_width, m_height, GL_RGB, GL_UNSIGNED_BYTE, nullptr);
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    m_syncObjects[m_writeSlot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    m_slotPending[m_writeSlot] = true;
+    m_slotFrameNumber[m_writeSlot] = m_frameCounter;
+    m_writeSlot = (m_writeSlot + 1) % kRingSize;
+
+    m_capturesIssued++;
+}
+
+/***********************************************************
+ *  WriterThreadMain()
+ *
+ *  Pops finished frames off the queue and writes them as binary
+ *  PPM files named after the frame each was captured from, so
+ *  the files sort chronologically even when the harvest pass
+ *  drains ring slots out of issue order. Runs until Shutdown()
+ *  drains the queue.
+ ***********************************************************/
+void FrameCapture::WriterThreadMain()
+{
+    for (;;)
+    {
+        CaptureJob job;
+        {
+            std::unique_lock<std::mutex> lock(m_queueMutex);
+            m_queueCondition.wait(lock, [this]
+                { return m_bStopWriter || !m_jobQueue.empty(); });
+
+            if (m_jobQueue.empty())
+            {
+                // stop was requested and nothing is left to write
+                return;
+            }
+
+            job = std::move(m_jobQueue.front());
+            m_jobQueue.pop();
+        }
+
+        char filename[64];
+        snprintf(filename, sizeof(filename), "%s%05llu.ppm",
+            kCaptureFilePrefix, job.frameNumber);
+
+        if (WritePPM(filename, job.width, job.height, job.pixels))
+        {
+            m_framesWritten++;
+        }
+        else
+        {
+            std::cout << "FrameCapture: could not write " << filename << std::endl;
+        }
+    }
+}
+
+/***********************************************************
+ *  HasPendingReadbacks()
+ ***********************************************************/
+bool FrameCapture::HasPendingReadbacks() const
+{
+    if (!m_bInitialized)
+    {
+        return false;
+    }
+
+    for (int i = 0; i < kRingSize; ++i)
+    {
+        if (m_slotPending[i])
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/***********************************************************
+ *  DumpStats()
+ ***********************************************************/
+void FrameCapture::DumpStats() const
+{
+    if (!m_bInitialized || (m_capturesIssued == 0))
+    {
+        return;
+    }
+
+    std::cout << "CAPTURE: readbacks issued " << m_capturesIssued
+        << ", frames written " << m_framesWritten << std::endl;
+}
+
+/***********************************************************
+ *  Shutdown()
+ *
+ *  Drains the outstanding readbacks (waiting on their fences),
+ *  lets the writer finish the queue, and deletes the GL objects.
+ ***********************************************************/
+void FrameCapture::Shutdown()
+{
+    if (!m_bInitialized)
+    {
+        return;
+    }
+
+    // force-complete whatever is still in flight
+    for (int i = 0; i < kRingSize; ++i)
+    {
+        HarvestSlot(i, true);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        m_bStopWriter = true;
+    }
+    m_queueCondition.notify_one();
+    if (m_writerThread.joinable())
+    {
+        m_writerThread.join();
+    }
+
+    glDeleteBuffers(kRingSize, m_pboIDs);
+    for (int i = 0; i < kRingSize; ++i)
+    {
+        m_pboIDs[i] = 0;
+    }
+
+    m_bInitialized = false;
+}
@@ -0,0 +1,100 @@
+///////////////////////////////////////////////////////////////////////////////
+// framecapture.h
+// ==============
+// asynchronous frame capture: a ring of pixel pack buffers reads the
+// backbuffer a few frames behind the render, and a background thread
+// writes the images to disk. The render thread only issues the async
+// readback and a memcpy out of an already-signaled buffer, so a
+// capture costs well under a millisecond on the hot path.
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+class FrameCapture
+{
+public:
+    // shared capture pipeline used by the main loop
+    static FrameCapture& Instance();
+
+    // creates the pixel-buffer ring for the given backbuffer size and
+    // starts the writer thread. Requires a current context.
+    bool Initialize(int width, int height);
+
+    // programmatic trigger: capture the next rendered frame (F12 path)
+    void RequestCapture();
+
+    // continuous recording on/off; every rendered frame is captured
+    // while enabled (benchmark recording)
+    void SetContinuous(bool bEnabled);
+
+    // call once per frame after the scene is in the backbuffer and
+    // before the swap: harvests finished readbacks without blocking
+    // and issues a new one when a capture is due
+    void OnFrameRendered();
+
+    // true while any async readback is still in flight; the main
+    // loop keeps rendering until pending captures drain, since the
+    // harvest only runs on rendered frames
+    bool HasPendingReadbacks() const;
+
+    // prints captures issued and frames written
+    void DumpStats() const;
+
+    // drains outstanding readbacks, stops the writer thread, and
+    // deletes the GL objects; safe to call without Initialize
+    void Shutdown();
+
+private:
+    FrameCapture();
+
+    // one finished frame handed to the writer thread
+    struct CaptureJob
+    {
+        int width;
+        int height;
+        unsigned long long frameNumber;
+        std::vector<unsigned char> pixels;   // tightly packed RGB
+    };
+
+    // maps a signaled buffer, queues its pixels for writing, and
+    // recycles the ring slot; bWait forces completion (shutdown)
+    void HarvestSlot(int slot, bool bWait);
+
+    // writer thread body: pops jobs and writes binary PPM files
+    void WriterThreadMain();
+
+    static const int kRingSize = 3;
+
+    int m_width;
+    int m_height;
+
+    unsigned int m_pboIDs[kRingSize];
+    void* m_syncObjects[kRingSize];   // GLsync, opaque here
+    bool m_slotPending[kRingSize];
+    unsigned long long m_slotFrameNumber[kRingSize];
+    int m_writeSlot;
+
+    bool m_bCaptureRequested;
+    bool m_bContinuous;
+    unsigned long long m_frameCounter;
+    unsigned long long m_capturesIssued;
+
+    // writer thread state
+    std::thread m_writerThread;
+    std::mutex m_queueMutex;
+    std::condition_variable m_queueCondition;
+    std::queue<CaptureJob> m_jobQueue;
+    bool m_bStopWriter;
+    unsigned long long m_framesWritten;
+
+    bool m_bInitialized;
+};
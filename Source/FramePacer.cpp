@@ -0,0 +1,211 @@
+///////////////////////////////////////////////////////////////////////////////
+// FramePacer.cpp
+//
+// Swap interval control, CPU frame limiting, and poll-to-swap latency
+// measurement. See FramePacer.h for the API.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "FramePacer.h"
+
+#include "GLFW/glfw3.h"
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+namespace
+{
+    const char* SwapModeName(FramePacer::SwapMode mode)
+    {
+        switch (mode)
+        {
+        case FramePacer::Immediate: return "immediate";
+        case FramePacer::VSync:     return "vsync";
+        case FramePacer::Adaptive:  return "adaptive";
+        }
+        return "unknown";
+    }
+
+    // precise sleep: coarse sleep_for until close to the deadline, then
+    // spin on the timer for the last stretch so we never oversleep
+    void SleepUntil(double deadlineSeconds)
+    {
+        const double kSpinWindowSeconds = 0.002;
+
+        double now = glfwGetTime();
+        if (deadlineSeconds - now > kSpinWindowSeconds)
+        {
+            std::this_thread::sleep_for(std::chrono::duration<double>(
+                deadlineSeconds - now - kSpinWindowSeconds));
+        }
+
+        while (glfwGetTime() < deadlineSeconds)
+        {
+            // spin out the remainder
+        }
+    }
+}
+
+/***********************************************************
+ *  Instance()
+ *
+ *  Returns the shared pacer instance used by the main loop.
+ ***********************************************************/
+FramePacer& FramePacer::Instance()
+{
+    static FramePacer s_instance;
+    return s_instance;
+}
+
+/***********************************************************
+ *  FramePacer()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+FramePacer::FramePacer()
+{
+    m_mode = VSync;
+    m_frameIntervalSeconds = 0.0;
+    m_pollTime = 0.0;
+    m_nextFrameDeadline = 0.0;
+    m_totalLatencySeconds = 0.0;
+    m_frameCount = 0;
+}
+
+/***********************************************************
+ *  SetSwapMode()
+ *
+ *  Applies the swap interval through GLFW. Adaptive needs the
+ *  swap_control_tear extension; without it we fall back to
+ *  plain vsync rather than leaving the driver default.
+ ***********************************************************/
+void FramePacer::SetSwapMode(SwapMode mode)
+{
+    if (mode == Adaptive)
+    {
+        const bool bTearSupported =
+            glfwExtensionSupported("WGL_EXT_swap_control_tear") ||
+            glfwExtensionSupported("GLX_EXT_swap_control_tear");
+        if (!bTearSupported)
+        {
+            std::cout << "PACING: adaptive vsync not supported, using vsync" << std::endl;
+            mode = VSync;
+        }
+    }
+
+    switch (mode)
+    {
+    case Immediate:
+        glfwSwapInterval(0);
+        break;
+    case VSync:
+        glfwSwapInterval(1);
+        break;
+    case Adaptive:
+        glfwSwapInterval(-1);
+        break;
+    }
+
+    m_mode = mode;
+    std::cout << "PACING: swap mode " << SwapModeName(m_mode) << std::endl;
+}
+
+/***********************************************************
+ *  CycleSwapMode()
+ *
+ *  Steps to the next pacing mode (hotkey path).
+ ***********************************************************/
+void FramePacer::CycleSwapMode()
+{
+    switch (m_mode)
+    {
+    case Immediate:
+        SetSwapMode(VSync);
+        break;
+    case VSync:
+        SetSwapMode(Adaptive);
+        break;
+    case Adaptive:
+        SetSwapMode(Immediate);
+        break;
+    }
+}
+
+/***********************************************************
+ *  SetFrameRateLimit()
+ *
+ *  Caps the frame rate with a CPU-side sleep in
+ *  MarkFrameSwapped(). Zero disables the limiter.
+ ***********************************************************/
+void FramePacer::SetFrameRateLimit(double framesPerSecond)
+{
+    if (framesPerSecond > 0.0)
+    {
+        m_frameIntervalSeconds = 1.0 / framesPerSecond;
+        std::cout << "PACING: frame limit " << framesPerSecond << " fps" << std::endl;
+    }
+    else
+    {
+        m_frameIntervalSeconds = 0.0;
+        std::cout << "PACING: frame limit off" << std::endl;
+    }
+    m_nextFrameDeadline = 0.0;
+}
+
+/***********************************************************
+ *  MarkEventsPolled()
+ *
+ *  Starts the poll-to-swap latency clock for this frame.
+ ***********************************************************/
+void FramePacer::MarkEventsPolled()
+{
+    m_pollTime = glfwGetTime();
+}
+
+/***********************************************************
+ *  MarkFrameSwapped()
+ *
+ *  Records the poll-to-swap latency and, when a frame limit is
+ *  set, sleeps out the rest of the frame interval.
+ ***********************************************************/
+void FramePacer::MarkFrameSwapped()
+{
+    const double now = glfwGetTime();
+
+    if (m_pollTime > 0.0)
+    {
+        m_totalLatencySeconds += (now - m_pollTime);
+        m_frameCount++;
+    }
+
+    if (m_frameIntervalSeconds > 0.0)
+    {
+        if ((m_nextFrameDeadline <= 0.0) || (m_nextFrameDeadline < now - m_frameIntervalSeconds))
+        {
+            // first limited frame, or we fell far behind: resynchronize
+            m_nextFrameDeadline = now + m_frameIntervalSeconds;
+        }
+        else
+        {
+            SleepUntil(m_nextFrameDeadline);
+            m_nextFrameDeadline += m_frameIntervalSeconds;
+        }
+    }
+}
+
+/***********************************************************
+ *  DumpStats()
+ *
+ *  Prints the pacing mode and average poll-to-swap latency.
+ ***********************************************************/
+void FramePacer::DumpStats() const
+{
+    std::cout << "PACING: mode " << SwapModeName(m_mode);
+    if (m_frameCount > 0)
+    {
+        std::cout << ", poll-to-swap avg "
+            << (m_totalLatencySeconds * 1000.0 / m_frameCount)
+            << " ms over " << m_frameCount << " frames";
+    }
+    std::cout << std::endl;
+}
@@ -0,0 +1,60 @@
+///////////////////////////////////////////////////////////////////////////////
+// framepacer.h
+// ============
+// explicit frame pacing for the main loop: swap interval control
+// (immediate / vsync / adaptive), an optional CPU frame limiter with
+// precise sleep, and input-to-present latency instrumentation measured
+// from glfwPollEvents to glfwSwapBuffers.
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+class FramePacer
+{
+public:
+    // presentation pacing modes, applied through glfwSwapInterval
+    enum SwapMode
+    {
+        Immediate = 0,   // swap interval 0: no vsync, frames as fast as possible
+        VSync = 1,       // swap interval 1: locked to the display refresh
+        Adaptive = 2     // swap interval -1: vsync that tears instead of stalling
+    };
+
+    // shared pacer instance used by the main loop
+    static FramePacer& Instance();
+
+    // applies the swap interval; Adaptive falls back to VSync when the
+    // swap_control_tear extension is missing. Requires a current context.
+    void SetSwapMode(SwapMode mode);
+
+    // cycles Immediate -> VSync -> Adaptive (hotkey path)
+    void CycleSwapMode();
+
+    // caps the frame rate on the CPU side; 0 disables the limiter.
+    // Useful with Immediate swap to avoid spinning at thousands of fps.
+    void SetFrameRateLimit(double framesPerSecond);
+
+    // call right after glfwPollEvents - starts the latency clock
+    void MarkEventsPolled();
+
+    // call right after glfwSwapBuffers - records the poll-to-swap
+    // latency and runs the frame limiter sleep if one is set
+    void MarkFrameSwapped();
+
+    // prints the pacing mode and average poll-to-swap latency
+    void DumpStats() const;
+
+private:
+    FramePacer();
+
+    SwapMode m_mode;
+    double m_frameIntervalSeconds;   // 0 when the limiter is off
+    double m_pollTime;               // glfwGetTime at MarkEventsPolled
+    double m_nextFrameDeadline;      // limiter target for the next frame
+
+    double m_totalLatencySeconds;
+    unsigned long long m_frameCount;
+};
@@ -0,0 +1,266 @@
+///////////////////////////////////////////////////////////////////////////////
+// gpuprofiler.cpp
+// ============
+// scoped GPU/CPU timing sections for finding hot spots inside a frame.
+// GPU sections use GL_TIME_ELAPSED queries with a small ring buffer per
+// section so results are read back several frames late and never stall
+// the pipeline. CPU sections ride the same API with a steady clock.
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include "GpuProfiler.h"
+
+#include <iostream>
+
+/***********************************************************
+ *  Instance()
+ *
+ *  Returns the shared profiler instance used by all of the
+ *  manager classes.
+ ***********************************************************/
+GpuProfiler& GpuProfiler::Instance()
+{
+    static GpuProfiler s_instance;
+    return s_instance;
+}
+
+/***********************************************************
+ *  GpuProfiler()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+GpuProfiler::GpuProfiler()
+{
+    m_activeGpuSection = -1;
+    m_activeCpuSection = -1;
+}
+
+/***********************************************************
+ *  ~GpuProfiler()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+GpuProfiler::~GpuProfiler()
+{
+    // the GL context is usually gone by the time statics are
+    // destroyed, so the query objects are not deleted here
+}
+
+/***********************************************************
+ *  FindOrAddSection()
+ *
+ *  Finds the named timing section, creating it (and its GL
+ *  query ring for GPU sections) on first use.
+ ***********************************************************/
+int GpuProfiler::FindOrAddSection(const char* sectionName, bool isGpuSection)
+{
+    for (size_t i = 0; i < m_sections.size(); i++)
+    {
+        if (m_sections[i].name == sectionName)
+        {
+            return (int)i;
+        }
+    }
+
+    Section section;
+    section.name = sectionName;
+    section.isGpuSection = isGpuSection;
+    section.writeSlot = 0;
+    section.totalMilliseconds = 0.0;
+    section.sampleCount = 0;
+    for (int slot = 0; slot < kRingSize; slot++)
+    {
+        section.queryIDs[slot] = 0;
+        section.queryPending[slot] = false;
+        section.pendingFrames[slot] = 0;
+    }
+    if (isGpuSection)
+    {
+        glGenQueries(kRingSize, section.queryIDs);
+    }
+
+    m_sections.push_back(section);
+    return (int)(m_sections.size() - 1);
+}
+
+/***********************************************************
+ *  BeginGpuSection()
+ *
+ *  Starts a GL_TIME_ELAPSED query for the named section. If
+ *  the next ring slot is still in flight the sample for this
+ *  frame is skipped rather than stalling on the result. A
+ *  glBeginQuery that fails (for example another GL_TIME_ELAPSED
+ *  query is already active) also just drops the sample - the
+ *  slot is never marked in flight for a query that never ran.
+ ***********************************************************/
+void GpuProfiler::BeginGpuSection(const char* sectionName)
+{
+    if (m_activeGpuSection >= 0)
+    {
+        return;
+    }
+
+    int index = FindOrAddSection(sectionName, true);
+    Section& section = m_sections[index];
+
+    if (section.queryPending[section.writeSlot])
+    {
+        // the whole ring is in flight - drop this sample
+        return;
+    }
+
+    // flush any stale GL error so the check below reflects this call
+    while (glGetError() != GL_NO_ERROR)
+    {
+    }
+
+    glBeginQuery(GL_TIME_ELAPSED, section.queryIDs[section.writeSlot]);
+    if (glGetError() != GL_NO_ERROR)
+    {
+        // the query never started - drop the sample instead of
+        // ending a query that is not ours
+        return;
+    }
+
+    m_activeGpuSection = index;
+}
+
+/***********************************************************
+ *  EndGpuSection()
+ *
+ *  Ends the active GPU timing section and advances its ring
+ *  slot for the next frame.
+ ***********************************************************/
+void GpuProfiler::EndGpuSection()
+{
+    if (m_activeGpuSection < 0)
+    {
+        return;
+    }
+
+    Section& section = m_sections[m_activeGpuSection];
+    glEndQuery(GL_TIME_ELAPSED);
+    section.queryPending[section.writeSlot] = true;
+    section.pendingFrames[section.writeSlot] = 0;
+    section.writeSlot = (section.writeSlot + 1) % kRingSize;
+    m_activeGpuSection = -1;
+}
+
+/***********************************************************
+ *  BeginCpuSection()
+ *
+ *  Starts a CPU timing section using a steady clock.
+ ***********************************************************/
+void GpuProfiler::BeginCpuSection(const char* sectionName)
+{
+    if (m_activeCpuSection >= 0)
+    {
+        return;
+    }
+
+    m_activeCpuSection = FindOrAddSection(sectionName, false);
+    m_cpuSectionStart = std::chrono::steady_clock::now();
+}
+
+/***********************************************************
+ *  EndCpuSection()
+ *
+ *  Ends the active CPU timing section and accumulates the
+ *  elapsed time into its running total.
+ ***********************************************************/
+void GpuProfiler::EndCpuSection()
+{
+    if (m_activeCpuSection < 0)
+    {
+        return;
+    }
+
+    std::chrono::steady_clock::time_point endTime = std::chrono::steady_clock::now();
+    double elapsedMs = std::chrono::duration<double, std::milli>(
+        endTime - m_cpuSectionStart).count();
+
+    Section& section = m_sections[m_activeCpuSection];
+    section.totalMilliseconds += elapsedMs;
+    section.sampleCount++;
+    m_activeCpuSection = -1;
+}
+
+/***********************************************************
+ *  CollectResults()
+ *
+ *  Polls the in-flight GPU queries and accumulates any that
+ *  have completed. Results that are not ready yet are left
+ *  for a later frame - this never blocks. A slot whose result
+ *  never arrives is reclaimed after kMaxPendingFrames passes
+ *  so the section keeps sampling instead of wedging once the
+ *  ring fills up.
+ ***********************************************************/
+void GpuProfiler::CollectResults()
+{
+    for (size_t i = 0; i < m_sections.size(); i++)
+    {
+        Section& section = m_sections[i];
+        if (!section.isGpuSection)
+        {
+            continue;
+        }
+
+        for (int slot = 0; slot < kRingSize; slot++)
+        {
+            if (!section.queryPending[slot])
+            {
+                continue;
+            }
+
+            GLuint available = 0;
+            glGetQueryObjectuiv(section.queryIDs[slot],
+                GL_QUERY_RESULT_AVAILABLE, &available);
+            if (available == GL_FALSE)
+            {
+                section.pendingFrames[slot]++;
+                if (section.pendingFrames[slot] >= kMaxPendingFrames)
+                {
+                    // give up on this result and free the slot
+                    section.queryPending[slot] = false;
+                    section.pendingFrames[slot] = 0;
+                }
+                continue;
+            }
+
+            GLuint64 elapsedNs = 0;
+            glGetQueryObjectui64v(section.queryIDs[slot],
+                GL_QUERY_RESULT, &elapsedNs);
+            section.totalMilliseconds += (double)elapsedNs / 1000000.0;
+            section.sampleCount++;
+            section.queryPending[slot] = false;
+            section.pendingFrames[slot] = 0;
+        }
+    }
+}
+
+/***********************************************************
+ *  DumpReport()
+ *
+ *  Prints the aggregated per-section averages to the console.
+ ***********************************************************/
+void GpuProfiler::DumpReport() const
+{
+    std::cout << "PROFILE: ---- per-section timing report ----" << std::endl;
+    for (size_t i = 0; i < m_sections.size(); i++)
+    {
+        const Section& section = m_sections[i];
+        if (section.sampleCount == 0)
+        {
+            continue;
+        }
+
+        double averageMs = section.totalMilliseconds / (double)section.sampleCount;
+        std::cout << "PROFILE: " << (section.isGpuSection ? "[GPU] " : "[CPU] ")
+            << section.name
+            << "  avg " << averageMs << " ms"
+            << "  over " << section.sampleCount << " samples" << std::endl;
+    }
+    std::cout << "PROFILE: -----------------------------------" << std::endl;
+}
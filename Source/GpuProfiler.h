@@ -0,0 +1,75 @@
+///////////////////////////////////////////////////////////////////////////////
+// gpuprofiler.h
+// ============
+// scoped GPU/CPU timing sections for finding hot spots inside a frame.
+// GPU sections use GL_TIME_ELAPSED queries with a small ring buffer per
+// section so results are read back several frames late and never stall
+// the pipeline. CPU sections ride the same API with a steady clock.
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+class GpuProfiler
+{
+public:
+    // shared profiler instance used by all managers
+    static GpuProfiler& Instance();
+
+    // marks the start/end of a GPU timing section; sections must not nest
+    void BeginGpuSection(const char* sectionName);
+    void EndGpuSection();
+
+    // marks the start/end of a CPU timing section; sections must not nest
+    void BeginCpuSection(const char* sectionName);
+    void EndCpuSection();
+
+    // collects finished GPU query results; call once per frame after
+    // the scene has been submitted
+    void CollectResults();
+
+    // prints the aggregated per-section report to the console
+    void DumpReport() const;
+
+private:
+    // number of in-flight queries kept per section - results are read
+    // back this many frames late to avoid pipeline stalls
+    static const int kRingSize = 4;
+
+    // a pending slot whose result has not arrived after this many
+    // collection passes is reclaimed without a sample, so one lost
+    // query can never wedge a section's ring permanently
+    static const int kMaxPendingFrames = 120;
+
+    // per-section timing state and running totals
+    struct Section
+    {
+        std::string name;
+        bool isGpuSection;
+        GLuint queryIDs[kRingSize];
+        bool queryPending[kRingSize];
+        int pendingFrames[kRingSize];
+        int writeSlot;
+        double totalMilliseconds;
+        unsigned long long sampleCount;
+    };
+
+    GpuProfiler();
+    ~GpuProfiler();
+
+    // finds the named section, creating it on first use
+    int FindOrAddSection(const char* sectionName, bool isGpuSection);
+
+    std::vector<Section> m_sections;
+    int m_activeGpuSection;
+    int m_activeCpuSection;
+    std::chrono::steady_clock::time_point m_cpuSectionStart;
+};
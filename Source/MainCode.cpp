@@ -1,5 +1,39 @@
 #include <iostream>         // error handling and output
 #include <cstdlib>          // EXIT_FAILURE
+#include <memory>           // scoped ownership of the managers
+
+#ifdef BENCHMARK_MODE
+#include <algorithm>        // std::sort for percentiles
+#include <atomic>           // allocation counter
+#include <cmath>            // sin, cos for the camera orbit
+#include <new>              // std::bad_alloc
+#include <vector>           // frame time samples
+
+// Counts every heap allocation so the benchmark can verify the render
+// path is allocation free - the per-frame count should read zero.
+static std::atomic<unsigned long long> gAllocationCount{ 0 };
+
+void* operator new(std::size_t size)
+{
+	gAllocationCount.fetch_add(1, std::memory_order_relaxed);
+	void* ptr = std::malloc(size);
+	if (ptr == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+	return ptr;
+}
+
+void operator delete(void* ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+	std::free(ptr);
+}
+#endif
 
 #include <GL/glew.h>        // GLEW library
 #include "GLFW/glfw3.h"     // GLFW library
@@ -13,22 +47,34 @@
 #include "ViewManager.h"
 #include "ShapeMeshes.h"
 #include "ShaderManager.h"
+#include "ShaderBinaryCache.h"
+#include "GpuProfiler.h"
+#include "FramePacer.h"
+#include "RenderTarget.h"
+#include "FrameCapture.h"
+#include "FrameArena.h"
 
 // Namespace for declaring global variables
 namespace
 {
 	// Macro for window title
-	const char* const WINDOW_TITLE = "7-1 FinalProject and Milestones"; 
+	const char* const WINDOW_TITLE = "7-1 FinalProject and Milestones";
+
+	// External GLSL shader source files
+	const char* const VERTEX_SHADER_PATH = "../../Utilities/shaders/vertexShader.glsl";
+	const char* const FRAGMENT_SHADER_PATH = "../../Utilities/shaders/fragmentShader.glsl";
 
 	// Main GLFW window
 	GLFWwindow* g_Window = nullptr;
 
+	// Managers owned by scoped storage so teardown runs in reverse
+	// declaration order without any manual delete bookkeeping.
 	// scene manager object for managing the 3D scene prepare and render
-	SceneManager* g_SceneManager = nullptr;
+	std::unique_ptr<SceneManager> g_SceneManager;
 	// shader manager object for dynamic interaction with the shader code
-	ShaderManager* g_ShaderManager = nullptr;
+	std::unique_ptr<ShaderManager> g_ShaderManager;
 	// view manager object for managing the 3D view setup and projection to 2D
-	ViewManager* g_ViewManager = nullptr;
+	std::unique_ptr<ViewManager> g_ViewManager;
 }
 
 // Function declarations - all functions that are called manually
@@ -36,6 +82,10 @@ namespace
 bool InitializeGLFW();
 bool InitializeGLEW();
 
+#ifdef BENCHMARK_MODE
+void RunBenchmark(GLFWwindow* window, int frameCount);
+#endif
+
 
 /***********************************************************
  *  main(int, char*)
@@ -52,10 +102,10 @@ int main(int argc, char* argv[])
 	}
 
 	// try to create a new shader manager object
-	g_ShaderManager = new ShaderManager();
+	g_ShaderManager = std::make_unique<ShaderManager>();
 	// try to create a new view manager object
-	g_ViewManager = new ViewManager(
-		g_ShaderManager);
+	g_ViewManager = std::make_unique<ViewManager>(
+		g_ShaderManager.get());
 
 	// try to create the main display window
 	g_Window = g_ViewManager->CreateDisplayWindow(WINDOW_TITLE);
@@ -66,20 +116,96 @@ int main(int argc, char* argv[])
 		return(EXIT_FAILURE);
 	}
 
-	// load the shader code from the external GLSL files
-	g_ShaderManager->LoadShaders(
-		"../../Utilities/shaders/vertexShader.glsl",
-		"../../Utilities/shaders/fragmentShader.glsl");
-	g_ShaderManager->use();
+	// explicit presentation pacing instead of the driver default
+#ifdef BENCHMARK_MODE
+	// benchmarks must never be paced by the display
+	FramePacer::Instance().SetSwapMode(FramePacer::Immediate);
+#else
+	FramePacer::Instance().SetSwapMode(FramePacer::VSync);
+#endif
+
+	// On a warm start the linked program binary is restored from the
+	// cache and GLSL compilation is skipped entirely. All uniform
+	// uploads go through UniformCache against the current program, so
+	// nothing depends on ShaderManager having compiled it itself.
+	if (ShaderBinaryCache::TryLoadProgram(VERTEX_SHADER_PATH, FRAGMENT_SHADER_PATH) == 0)
+	{
+		// cache miss: load the shader code from the external GLSL files
+		g_ShaderManager->LoadShaders(
+			VERTEX_SHADER_PATH,
+			FRAGMENT_SHADER_PATH);
+		g_ShaderManager->use();
+
+		// cache the linked binary for the next launch
+		ShaderBinaryCache::SaveActiveProgram(VERTEX_SHADER_PATH, FRAGMENT_SHADER_PATH);
+	}
 
 	// try to create a new scene manager object and prepare the 3D scene
-	g_SceneManager = new SceneManager(g_ShaderManager);
+	g_SceneManager = std::make_unique<SceneManager>(g_ShaderManager.get());
 	g_SceneManager->PrepareScene();
 
-	// loop will keep running until the application is closed 
+#ifdef BENCHMARK_MODE
+	// Offscreen benchmark: render a fixed number of frames along a
+	// scripted camera orbit and report frame-time statistics, then exit.
+	int benchmarkFrames = 1000;
+	if (argc > 1)
+	{
+		benchmarkFrames = std::atoi(argv[1]);
+		if (benchmarkFrames <= 0)
+		{
+			benchmarkFrames = 1000;
+		}
+	}
+	RunBenchmark(g_Window, benchmarkFrames);
+#else
+	// Internal render target with dynamic resolution scaling; if it
+	// fails to initialize, Begin/EndFrame are no-ops and the scene
+	// renders straight to the window as before.
+	{
+		int framebufferWidth = 0;
+		int framebufferHeight = 0;
+		glfwGetFramebufferSize(g_Window, &framebufferWidth, &framebufferHeight);
+		RenderTarget::Instance().Initialize(framebufferWidth, framebufferHeight);
+
+		// async capture pipeline (F12 single frame; SetContinuous for
+		// recording). Readbacks run a few frames behind the render.
+		FrameCapture::Instance().Initialize(framebufferWidth, framebufferHeight);
+	}
+
+	// loop will keep running until the application is closed
 	// or until an error has occurred
 	while (!glfwWindowShouldClose(g_Window))
 	{
+		// reclaim all of last frame's transient allocations at once
+		FrameArena::Instance().Reset();
+
+		// query the latest GLFW events
+		glfwPollEvents();
+		FramePacer::Instance().MarkEventsPolled();
+
+		// convert from 3D object space to 2D view; this also samples
+		// the keyboard, which is what marks the view dirty on input
+		g_ViewManager->PrepareSceneView();
+
+		// On-demand rendering: skip the draw entirely while neither
+		// the view nor the scene changed, and sleep until input
+		// arrives (or the timeout expires) instead of spinning.
+		// Single | so both flags are consumed every iteration. A
+		// pending capture readback also keeps frames coming, since
+		// the harvest only runs on rendered frames.
+		const bool bRedrawNeeded =
+			g_ViewManager->ConsumeViewDirty() |
+			g_SceneManager->ConsumeSceneDirty() |
+			FrameCapture::Instance().HasPendingReadbacks();
+		if (!bRedrawNeeded)
+		{
+			glfwWaitEventsTimeout(0.1);
+			continue;
+		}
+
+		// render into the scaled internal target
+		RenderTarget::Instance().BeginFrame();
+
 		// Enable z-depth
 		glEnable(GL_DEPTH_TEST);
 
@@ -87,36 +213,43 @@ int main(int argc, char* argv[])
 		glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-		// convert from 3D object space to 2D view
-		g_ViewManager->PrepareSceneView();
+		// hand the eye position and frustum over for culling
+		g_SceneManager->SetCameraPosition(g_ViewManager->GetCameraPosition());
+		g_SceneManager->SetViewProjection(g_ViewManager->GetViewProjectionMatrix());
 
 		// refresh the 3D scene
 		g_SceneManager->RenderScene();
 
+		// upsample to the window and update the auto scale
+		RenderTarget::Instance().EndFrame();
+
+		// async readback of the finished backbuffer when a capture
+		// was requested; harvests completed transfers either way
+		FrameCapture::Instance().OnFrameRendered();
 
 		// Flips the the back buffer with the front buffer every frame.
 		glfwSwapBuffers(g_Window);
-
-		// query the latest GLFW events
-		glfwPollEvents();
+		FramePacer::Instance().MarkFrameSwapped();
 	}
 
-	// clear the allocated manager objects from memory
-	if (NULL != g_SceneManager)
-	{
-		delete g_SceneManager;
-		g_SceneManager = NULL;
-	}
-	if (NULL != g_ViewManager)
-	{
-		delete g_ViewManager;
-		g_ViewManager = NULL;
-	}
-	if (NULL != g_ShaderManager)
-	{
-		delete g_ShaderManager;
-		g_ShaderManager = NULL;
-	}
+	FrameCapture::Instance().DumpStats();
+	FrameCapture::Instance().Shutdown();
+
+	RenderTarget::Instance().DumpStats();
+	RenderTarget::Instance().Shutdown();
+#endif
+
+	// dump the aggregated GPU/CPU timing report before shutdown
+	GpuProfiler::Instance().DumpReport();
+	UniformCache::DumpStats();
+	FramePacer::Instance().DumpStats();
+	FrameArena::Instance().DumpStats();
+
+	// release the managers in reverse creation order while the GL
+	// context is still current (the scene frees GL objects)
+	g_SceneManager.reset();
+	g_ViewManager.reset();
+	g_ShaderManager.reset();
 
 	// Terminates the program successfully
 	exit(EXIT_SUCCESS); 
@@ -133,6 +266,11 @@ bool InitializeGLFW()
 	// --------------------------------------
 	glfwInit();
 
+#ifdef BENCHMARK_MODE
+	// benchmark runs render offscreen; never show a window
+	glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+#endif
+
 #ifdef __APPLE__
 	// set the version of OpenGL and profile to use
 	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
@@ -174,4 +312,109 @@ bool InitializeGLEW()
 	std::cout << "INFO: OpenGL Version: " << glGetString(GL_VERSION) << "\n" << std::endl;
 
 	return(true);
-}
\ No newline at end of file
+}
+
+#ifdef BENCHMARK_MODE
+/***********************************************************
+ *	RunBenchmark()
+ *
+ *  Renders frameCount frames with the camera orbiting the scene
+ *  and prints frame-time mean/p50/p99 plus per-stage CPU timings
+ *  to stdout. glFinish() per frame makes the numbers include GPU
+ *  completion, since a hidden window has no vsync to pace it.
+ ***********************************************************/
+void RunBenchmark(GLFWwindow* window, int frameCount)
+{
+	// scripted camera: one full orbit around the tabletop objects
+	const glm::vec3 orbitTarget(0.0f, 1.0f, -1.0f);
+	const float orbitRadius = 12.0f;
+	const float orbitHeight = 5.0f;
+	const float twoPi = 6.28318530718f;
+
+	std::vector<double> frameTimesMs;
+	frameTimesMs.reserve(frameCount);
+
+	double viewSeconds = 0.0;
+	double sceneSeconds = 0.0;
+	double syncSeconds = 0.0;
+
+	// the sample vector is preallocated, so the loop itself should
+	// not touch the heap at all
+	const unsigned long long allocationsBefore = gAllocationCount.load();
+
+	for (int frame = 0; frame < frameCount; ++frame)
+	{
+		// reclaim all of last frame's transient allocations at once
+		FrameArena::Instance().Reset();
+
+		const double frameStart = glfwGetTime();
+
+		// Enable z-depth
+		glEnable(GL_DEPTH_TEST);
+
+		// Clear the frame and z buffers
+		glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+		const float angle = (twoPi * frame) / static_cast<float>(frameCount);
+		const glm::vec3 cameraPos = orbitTarget + glm::vec3(
+			std::sin(angle) * orbitRadius,
+			orbitHeight,
+			std::cos(angle) * orbitRadius);
+		g_ViewManager->SetCameraPose(cameraPos, orbitTarget - cameraPos);
+
+		const double viewStart = glfwGetTime();
+		g_ViewManager->PrepareSceneView();
+		g_SceneManager->SetCameraPosition(g_ViewManager->GetCameraPosition());
+		g_SceneManager->SetViewProjection(g_ViewManager->GetViewProjectionMatrix());
+
+		const double sceneStart = glfwGetTime();
+		g_SceneManager->RenderScene();
+
+		const double syncStart = glfwGetTime();
+		glFinish();
+
+		const double frameEnd = glfwGetTime();
+
+		viewSeconds += (sceneStart - viewStart);
+		sceneSeconds += (syncStart - sceneStart);
+		syncSeconds += (frameEnd - syncStart);
+		frameTimesMs.push_back((frameEnd - frameStart) * 1000.0);
+
+		glfwSwapBuffers(window);
+		glfwPollEvents();
+	}
+
+	const unsigned long long loopAllocations =
+		gAllocationCount.load() - allocationsBefore;
+
+	std::sort(frameTimesMs.begin(), frameTimesMs.end());
+
+	double totalMs = 0.0;
+	for (const double sample : frameTimesMs)
+	{
+		totalMs += sample;
+	}
+
+	const size_t count = frameTimesMs.size();
+	const double meanMs = totalMs / count;
+	const double p50Ms = frameTimesMs[count / 2];
+	size_t p99Index = static_cast<size_t>(count * 0.99);
+	if (p99Index >= count)
+	{
+		p99Index = count - 1;
+	}
+	const double p99Ms = frameTimesMs[p99Index];
+
+	std::cout << "BENCHMARK: frames            " << count << "\n";
+	std::cout << "BENCHMARK: frame mean (ms)   " << meanMs << "\n";
+	std::cout << "BENCHMARK: frame p50 (ms)    " << p50Ms << "\n";
+	std::cout << "BENCHMARK: frame p99 (ms)    " << p99Ms << "\n";
+	std::cout << "BENCHMARK: fps (mean)        " << (1000.0 / meanMs) << "\n";
+	std::cout << "BENCHMARK: PrepareSceneView  " << (viewSeconds * 1000.0 / count) << " ms/frame\n";
+	std::cout << "BENCHMARK: RenderScene       " << (sceneSeconds * 1000.0 / count) << " ms/frame\n";
+	std::cout << "BENCHMARK: glFinish (GPU)    " << (syncSeconds * 1000.0 / count) << " ms/frame\n";
+	std::cout << "BENCHMARK: heap allocations  " << loopAllocations
+		<< " (" << (static_cast<double>(loopAllocations) / count) << " per frame)" << std::endl;
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,401 @@
+///////////////////////////////////////////////////////////////////////////////
+// rendertarget.cpp
+// ================
+// internal framebuffer with dynamic resolution scaling. The color and
+// depth attachments are allocated once at the full window size; the
+// render scale only changes the viewport and blit rectangles, so the
+// auto controller can move the scale every frame without touching GL
+// object allocation.
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include "RenderTarget.h"
+
+#include <GL/glew.h>
+
+#include <iostream>
+
+namespace
+{
+    // auto-mode tuning: one over-budget frame drops the scale a step;
+    // the scale climbs back only after sustained headroom
+    const float kScaleStep = 0.05f;
+    const float kMinScale = 0.50f;
+    const float kMaxScale = 1.00f;
+    const double kHeadroomFraction = 0.70;  // of the target budget
+    const int kFramesBeforeScaleUp = 30;
+
+    const char* ScaleModeName(RenderTarget::ScaleMode mode)
+    {
+        switch (mode)
+        {
+        case RenderTarget::Auto:     return "auto";
+        case RenderTarget::Fixed100: return "fixed 100%";
+        case RenderTarget::Fixed75:  return "fixed 75%";
+        case RenderTarget::Fixed50:  return "fixed 50%";
+        }
+        return "unknown";
+    }
+}
+
+/***********************************************************
+ *  Instance()
+ *
+ *  Shared render target used by the main loop.
+ ***********************************************************/
+RenderTarget& RenderTarget::Instance()
+{
+    static RenderTarget instance;
+    return instance;
+}
+
+/***********************************************************
+ *  RenderTarget()
+ ***********************************************************/
+RenderTarget::RenderTarget()
+{
+    m_mode = Auto;
+    m_renderScale = 1.0f;
+
+    m_windowWidth = 0;
+    m_windowHeight = 0;
+
+    m_framebufferID = 0;
+    m_colorbufferID = 0;
+    m_depthbufferID = 0;
+
+    for (int i = 0; i < kQueryRingSize; ++i)
+    {
+        m_beginQueryIDs[i] = 0;
+        m_endQueryIDs[i] = 0;
+        m_queryPending[i] = false;
+    }
+    m_queryWriteSlot = 0;
+    m_bTimerActive = false;
+
+    m_targetMilliseconds = 16.0;
+    m_headroomFrames = 0;
+
+    m_scaleDowns = 0;
+    m_scaleUps = 0;
+
+    m_bInitialized = false;
+}
+
+/***********************************************************
+ *  Initialize()
+ *
+ *  Creates the offscreen color/depth renderbuffers at the full
+ *  window size and the GPU timer query ring. On any failure the
+ *  target stays uninitialized and Begin/EndFrame become no-ops,
+ *  so the scene falls back to the default framebuffer.
+ ***********************************************************/
+bool RenderTarget::Initialize(int windowWidth, int windowHeight)
+{
+    if ((windowWidth <= 0) || (windowHeight <= 0))
+    {
+        std::cout << "RenderTarget: invalid window size "
+            << windowWidth << "x" << windowHeight << std::endl;
+        return false;
+    }
+
+    m_windowWidth = windowWidth;
+    m_windowHeight = windowHeight;
+
+    glGenFramebuffers(1, &m_framebufferID);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebufferID);
+
+    glGenRenderbuffers(1, &m_colorbufferID);
+    glBindRenderbuffer(GL_RENDERBUFFER, m_colorbufferID);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, windowWidth, windowHeight);
+    glFramebufferRenderbuffer(
+        GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_colorbufferID);
+
+    glGenRenderbuffers(1, &m_depthbufferID);
+    glBindRenderbuffer(GL_RENDERBUFFER, m_depthbufferID);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, windowWidth, windowHeight);
+    glFramebufferRenderbuffer(
+        GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, m_depthbufferID);
+
+    const GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    if (status != GL_FRAMEBUFFER_COMPLETE)
+    {
+        std::cout << "RenderTarget: framebuffer incomplete, rendering "
+            << "direct to the window instead" << std::endl;
+        Shutdown();
+        return false;
+    }
+
+    glGenQueries(kQueryRingSize, m_beginQueryIDs);
+    glGenQueries(kQueryRingSize, m_endQueryIDs);
+
+    m_bInitialized = true;
+
+    std::cout << "INFO: render target " << windowWidth << "x" << windowHeight
+        << ", scale mode " << ScaleModeName(m_mode) << std::endl;
+
+    return true;
+}
+
+/***********************************************************
+ *  ScaledWidth() / ScaledHeight()
+ ***********************************************************/
+int RenderTarget::ScaledWidth() const
+{
+    const int width = static_cast<int>(m_windowWidth * m_renderScale);
+    return (width > 0) ? width : 1;
+}
+
+int RenderTarget::ScaledHeight() const
+{
+    const int height = static_cast<int>(m_windowHeight * m_renderScale);
+    return (height > 0) ? height : 1;
+}
+
+/***********************************************************
+ *  BeginFrame()
+ *
+ *  Binds the internal framebuffer with the scaled viewport and
+ *  stamps the start of this frame's GPU timer if a query slot
+ *  is free. GL_TIMESTAMP stamps do not open a query scope, so
+ *  the profiler's GL_TIME_ELAPSED sections can run inside the
+ *  frame without colliding with this timer.
+ ***********************************************************/
+void RenderTarget::BeginFrame()
+{
+    if (!m_bInitialized)
+    {
+        return;
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebufferID);
+    glViewport(0, 0, ScaledWidth(), ScaledHeight());
+
+    if (!m_queryPending[m_queryWriteSlot])
+    {
+        glQueryCounter(m_beginQueryIDs[m_queryWriteSlot], GL_TIMESTAMP);
+        m_bTimerActive = true;
+    }
+}
+
+/***********************************************************
+ *  EndFrame()
+ *
+ *  Stamps the end of the GPU timer, upsamples the scaled region
+ *  to the full window, and feeds any completed timings into the
+ *  auto-scale controller. Query results are read only when
+ *  available, so the controller runs a few frames behind and
+ *  never stalls.
+ ***********************************************************/
+void RenderTarget::EndFrame()
+{
+    if (!m_bInitialized)
+    {
+        return;
+    }
+
+    if (m_bTimerActive)
+    {
+        glQueryCounter(m_endQueryIDs[m_queryWriteSlot], GL_TIMESTAMP);
+        m_queryPending[m_queryWriteSlot] = true;
+        m_queryWriteSlot = (m_queryWriteSlot + 1) % kQueryRingSize;
+        m_bTimerActive = false;
+    }
+
+    // linear filtering upsamples the scaled image; at 100% the rects
+    // match and the blit is a straight copy
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, m_framebufferID);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    glBlitFramebuffer(
+        0, 0, ScaledWidth(), ScaledHeight(),
+        0, 0, m_windowWidth, m_windowHeight,
+        GL_COLOR_BUFFER_BIT, GL_LINEAR);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(0, 0, m_windowWidth, m_windowHeight);
+
+    // harvest whatever query results have completed; the end stamp is
+    // written after the begin stamp, so once it is available both are
+    for (int i = 0; i < kQueryRingSize; ++i)
+    {
+        if (!m_queryPending[i])
+        {
+            continue;
+        }
+
+        GLint available = 0;
+        glGetQueryObjectiv(m_endQueryIDs[i], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available)
+        {
+            continue;
+        }
+
+        GLuint64 beginNs = 0;
+        GLuint64 endNs = 0;
+        glGetQueryObjectui64v(m_beginQueryIDs[i], GL_QUERY_RESULT, &beginNs);
+        glGetQueryObjectui64v(m_endQueryIDs[i], GL_QUERY_RESULT, &endNs);
+        m_queryPending[i] = false;
+
+        if ((m_mode == Auto) && (endNs > beginNs))
+        {
+            UpdateAutoScale(static_cast<double>(endNs - beginNs) / 1000000.0);
+        }
+    }
+}
+
+/***********************************************************
+ *  UpdateAutoScale()
+ *
+ *  One completed GPU frame time steers the scale: a single
+ *  over-budget frame drops it a step, and it climbs back only
+ *  after sustained headroom, so the scale does not oscillate at
+ *  the budget boundary.
+ ***********************************************************/
+void RenderTarget::UpdateAutoScale(double gpuMilliseconds)
+{
+    if (gpuMilliseconds > m_targetMilliseconds)
+    {
+        if (m_renderScale > kMinScale)
+        {
+            m_renderScale -= kScaleStep;
+            if (m_renderScale < kMinScale)
+            {
+                m_renderScale = kMinScale;
+            }
+            m_scaleDowns++;
+        }
+        m_headroomFrames = 0;
+        return;
+    }
+
+    if ((gpuMilliseconds < (m_targetMilliseconds * kHeadroomFraction)) &&
+        (m_renderScale < kMaxScale))
+    {
+        m_headroomFrames++;
+        if (m_headroomFrames >= kFramesBeforeScaleUp)
+        {
+            m_renderScale += kScaleStep;
+            if (m_renderScale > kMaxScale)
+            {
+                m_renderScale = kMaxScale;
+            }
+            m_scaleUps++;
+            m_headroomFrames = 0;
+        }
+        return;
+    }
+
+    m_headroomFrames = 0;
+}
+
+/***********************************************************
+ *  ApplyScaleMode()
+ ***********************************************************/
+void RenderTarget::ApplyScaleMode()
+{
+    switch (m_mode)
+    {
+    case Auto:
+        // keep the current scale as the controller's starting point
+        break;
+    case Fixed100:
+        m_renderScale = 1.00f;
+        break;
+    case Fixed75:
+        m_renderScale = 0.75f;
+        break;
+    case Fixed50:
+        m_renderScale = 0.50f;
+        break;
+    }
+    m_headroomFrames = 0;
+}
+
+/***********************************************************
+ *  CycleScaleMode()
+ *
+ *  Hotkey path: Auto -> 100% -> 75% -> 50% -> Auto.
+ ***********************************************************/
+void RenderTarget::CycleScaleMode()
+{
+    switch (m_mode)
+    {
+    case Auto:     m_mode = Fixed100; break;
+    case Fixed100: m_mode = Fixed75;  break;
+    case Fixed75:  m_mode = Fixed50;  break;
+    case Fixed50:  m_mode = Auto;     break;
+    }
+
+    ApplyScaleMode();
+
+    std::cout << "INFO: render scale mode: " << ScaleModeName(m_mode)
+        << " (scale " << m_renderScale << ")" << std::endl;
+}
+
+/***********************************************************
+ *  SetTargetFrameTime()
+ ***********************************************************/
+void RenderTarget::SetTargetFrameTime(double milliseconds)
+{
+    if (milliseconds > 0.0)
+    {
+        m_targetMilliseconds = milliseconds;
+    }
+}
+
+/***********************************************************
+ *  DumpStats()
+ ***********************************************************/
+void RenderTarget::DumpStats() const
+{
+    if (!m_bInitialized)
+    {
+        return;
+    }
+
+    std::cout << "RENDERTARGET: mode " << ScaleModeName(m_mode)
+        << ", scale " << m_renderScale
+        << " (" << ScaledWidth() << "x" << ScaledHeight()
+        << " -> " << m_windowWidth << "x" << m_windowHeight << ")"
+        << ", downs " << m_scaleDowns
+        << ", ups " << m_scaleUps << std::endl;
+}
+
+/***********************************************************
+ *  Shutdown()
+ ***********************************************************/
+void RenderTarget::Shutdown()
+{
+    if (m_framebufferID != 0)
+    {
+        glDeleteFramebuffers(1, &m_framebufferID);
+        m_framebufferID = 0;
+    }
+    if (m_colorbufferID != 0)
+    {
+        glDeleteRenderbuffers(1, &m_colorbufferID);
+        m_colorbufferID = 0;
+    }
+    if (m_depthbufferID != 0)
+    {
+        glDeleteRenderbuffers(1, &m_depthbufferID);
+        m_depthbufferID = 0;
+    }
+    if (m_bInitialized)
+    {
+        glDeleteQueries(kQueryRingSize, m_beginQueryIDs);
+        glDeleteQueries(kQueryRingSize, m_endQueryIDs);
+        for (int i = 0; i < kQueryRingSize; ++i)
+        {
+            m_beginQueryIDs[i] = 0;
+            m_endQueryIDs[i] = 0;
+            m_queryPending[i] = false;
+        }
+    }
+    m_bInitialized = false;
+}
@@ -0,0 +1,103 @@
+///////////////////////////////////////////////////////////////////////////////
+// rendertarget.h
+// ==============
+// internal framebuffer the scene renders into at an adjustable scale,
+// blitted (upsampled) to the window each frame. Decouples fill cost
+// from the window size; an automatic mode drops the render scale when
+// the measured GPU frame time exceeds a target budget and raises it
+// back when there is headroom.
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+class RenderTarget
+{
+public:
+    // scaling modes cycled by the F11 hotkey
+    enum ScaleMode
+    {
+        Auto = 0,        // scale follows the measured GPU frame time
+        Fixed100 = 1,    // always render at window resolution
+        Fixed75 = 2,     // fixed 75% linear scale
+        Fixed50 = 3      // fixed 50% linear scale
+    };
+
+    // shared render target used by the main loop
+    static RenderTarget& Instance();
+
+    // creates the offscreen color/depth attachments at the full window
+    // size; the scale only changes the viewport and blit rectangle, so
+    // scale changes never reallocate. Requires a current context.
+    bool Initialize(int windowWidth, int windowHeight);
+
+    // binds the internal framebuffer and sets the scaled viewport;
+    // also stamps the start of the GPU frame timer that drives the
+    // auto mode
+    void BeginFrame();
+
+    // resolves the scaled region to the full window (linear upsample),
+    // rebinds the default framebuffer, and feeds the completed GPU
+    // timings into the auto-scale controller
+    void EndFrame();
+
+    // cycles Auto -> 100% -> 75% -> 50% (hotkey path)
+    void CycleScaleMode();
+
+    // GPU frame-time budget the auto mode steers toward, in
+    // milliseconds (default 16.0, just inside 60 fps)
+    void SetTargetFrameTime(double milliseconds);
+
+    // prints the scale mode, current scale, and adjustment counts
+    void DumpStats() const;
+
+    // deletes the GL objects; safe to call without Initialize
+    void Shutdown();
+
+private:
+    RenderTarget();
+
+    // applies a fixed scale or seeds the auto controller for m_mode
+    void ApplyScaleMode();
+
+    // auto mode: nudges the scale from one completed GPU frame time
+    void UpdateAutoScale(double gpuMilliseconds);
+
+    // current scaled viewport size in pixels
+    int ScaledWidth() const;
+    int ScaledHeight() const;
+
+    ScaleMode m_mode;
+    float m_renderScale;             // linear scale, 0.5 .. 1.0
+
+    int m_windowWidth;
+    int m_windowHeight;
+
+    unsigned int m_framebufferID;
+    unsigned int m_colorbufferID;    // renderbuffer, blit source
+    unsigned int m_depthbufferID;
+
+    // GL_TIMESTAMP query pairs around the scene portion of the frame
+    // (elapsed = end stamp - begin stamp); timestamp stamps do not
+    // open a query scope, so they coexist with the GpuProfiler's
+    // GL_TIME_ELAPSED sections inside the frame. Results are consumed
+    // a few frames late, never a stall.
+    static const int kQueryRingSize = 4;
+    unsigned int m_beginQueryIDs[kQueryRingSize];
+    unsigned int m_endQueryIDs[kQueryRingSize];
+    bool m_queryPending[kQueryRingSize];
+    int m_queryWriteSlot;
+    bool m_bTimerActive;
+
+    double m_targetMilliseconds;
+    // hysteresis: scale drops on a single over-budget frame but only
+    // rises after this many consecutive frames with clear headroom
+    int m_headroomFrames;
+
+    unsigned long long m_scaleDowns;
+    unsigned long long m_scaleUps;
+
+    bool m_bInitialized;
+};
@@ -0,0 +1,208 @@
+///////////////////////////////////////////////////////////////////////////////
+// SceneFile.cpp
+//
+// Compiles Scene/scene.txt to packed records in scene.bin and reads the
+// records back at startup. See SceneFile.h for both formats.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SceneFile.h"
+
+#include <sys/stat.h>
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace
+{
+    constexpr uint32_t kSceneMagic = 0x31424353;  // 'SCB1'
+    constexpr uint32_t kSceneVersion = 1;
+
+    // Fixed-size header at the front of the binary scene file.
+    struct SceneHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        int32_t recordCount;
+    };
+
+    // Object type names accepted in the text file, indexed by the
+    // SceneFile::ObjectType id they compile to.
+    const char* const kObjectTypeNames[] =
+    {
+        "floor",
+        "backdrop",
+        "coaster",
+        "mug",
+        "can",
+        "woodblock",
+        "sphere"
+    };
+    constexpr int kObjectTypeCount =
+        sizeof(kObjectTypeNames) / sizeof(kObjectTypeNames[0]);
+
+    // Returns the file modification time, or -1 when the file is missing.
+    long long FileModTime(const char* path)
+    {
+        struct stat info;
+        if (stat(path, &info) != 0)
+        {
+            return -1;
+        }
+        return static_cast<long long>(info.st_mtime);
+    }
+}
+
+/***********************************************************
+ *  LoadScene()
+ *
+ *  Recompiles the binary when the text file is newer, then
+ *  reads the packed records. A missing text file with a valid
+ *  binary still loads.
+ ***********************************************************/
+bool SceneFile::LoadScene(
+    const char* textPath,
+    const char* binaryPath,
+    std::vector<SceneRecord>& records)
+{
+    records.clear();
+
+    const long long textTime = FileModTime(textPath);
+    const long long binaryTime = FileModTime(binaryPath);
+
+    if ((textTime >= 0) && (binaryTime < textTime))
+    {
+        if (!CompileTextToBinary(textPath, binaryPath))
+        {
+            return false;
+        }
+    }
+
+    return ReadBinary(binaryPath, records);
+}
+
+/***********************************************************
+ *  CompileTextToBinary()
+ *
+ *  Parses the human-editable text layout and writes the packed
+ *  record file. Unknown object names fail the compile so a typo
+ *  never silently drops an object.
+ ***********************************************************/
+bool SceneFile::CompileTextToBinary(const char* textPath, const char* binaryPath)
+{
+    std::ifstream textFile(textPath);
+    if (!textFile.is_open())
+    {
+        return false;
+    }
+
+    std::vector<SceneRecord> records;
+    std::string line;
+    int lineNumber = 0;
+
+    while (std::getline(textFile, line))
+    {
+        lineNumber++;
+
+        // skip blank lines and comments
+        std::istringstream stream(line);
+        std::string typeName;
+        if (!(stream >> typeName) || typeName[0] == '#')
+        {
+            continue;
+        }
+
+        int objectType = -1;
+        for (int i = 0; i < kObjectTypeCount; ++i)
+        {
+            if (typeName == kObjectTypeNames[i])
+            {
+                objectType = i;
+                break;
+            }
+        }
+
+        SceneRecord record{};
+        if ((objectType < 0) ||
+            !(stream >> record.positionX >> record.positionY >> record.positionZ))
+        {
+            std::cout << "SceneFile: bad line " << lineNumber
+                << " in " << textPath << ": " << line << std::endl;
+            return false;
+        }
+
+        record.objectType = objectType;
+        records.push_back(record);
+    }
+
+    FILE* file = fopen(binaryPath, "wb");
+    if (!file)
+    {
+        std::cout << "SceneFile: could not write " << binaryPath << std::endl;
+        return false;
+    }
+
+    SceneHeader header{};
+    header.magic = kSceneMagic;
+    header.version = kSceneVersion;
+    header.recordCount = static_cast<int32_t>(records.size());
+
+    bool success = (fwrite(&header, sizeof(header), 1, file) == 1);
+    if (success && !records.empty())
+    {
+        success = (fwrite(records.data(), sizeof(SceneRecord),
+            records.size(), file) == records.size());
+    }
+    fclose(file);
+
+    if (!success)
+    {
+        // never leave a truncated binary behind
+        remove(binaryPath);
+        return false;
+    }
+
+    std::cout << "SceneFile: compiled " << records.size()
+        << " objects from " << textPath << std::endl;
+    return true;
+}
+
+/***********************************************************
+ *  ReadBinary()
+ *
+ *  Reads the packed records in a single fread - no per-object
+ *  parsing happens at startup.
+ ***********************************************************/
+bool SceneFile::ReadBinary(const char* binaryPath, std::vector<SceneRecord>& records)
+{
+    FILE* file = fopen(binaryPath, "rb");
+    if (!file)
+    {
+        return false;
+    }
+
+    SceneHeader header{};
+    if (fread(&header, sizeof(header), 1, file) != 1 ||
+        header.magic != kSceneMagic ||
+        header.version != kSceneVersion ||
+        header.recordCount < 0)
+    {
+        fclose(file);
+        return false;
+    }
+
+    records.resize(header.recordCount);
+    if (header.recordCount > 0 &&
+        fread(records.data(), sizeof(SceneRecord),
+            header.recordCount, file) != static_cast<size_t>(header.recordCount))
+    {
+        // truncated file: treat the whole scene as invalid
+        fclose(file);
+        records.clear();
+        return false;
+    }
+
+    fclose(file);
+    return true;
+}
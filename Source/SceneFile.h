@@ -0,0 +1,63 @@
+///////////////////////////////////////////////////////////////////////////////
+// scenefile.h
+// ============
+// Data-driven scene layout: object placement lives in Scene/scene.txt
+// instead of hardcoded Build* calls, so moving an object is a text edit
+// rather than a rebuild of the project.
+//
+// The text file is compiled to a packed binary (scene.bin) whenever it
+// is newer; startup then reads the fixed-size records in one go with no
+// parsing. The same freshness rule as the texture cache applies: a
+// missing text file with an existing binary still loads, so deployments
+// can ship only the compiled scene.
+//
+// Text format, one object per line:
+//     <type> <x> <y> <z>
+// where <type> is one of: floor, backdrop, coaster, mug, can,
+// woodblock, sphere. Blank lines and lines starting with # are skipped.
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class SceneFile
+{
+public:
+    // Object type ids shared between the compiler and SceneManager's
+    // dispatch switch. Order is part of the binary format.
+    enum ObjectType
+    {
+        Floor = 0,
+        Backdrop = 1,
+        Coaster = 2,
+        Mug = 3,
+        Can = 4,
+        WoodBlock = 5,
+        Sphere = 6
+    };
+
+    // One placed object; the packed record layout in scene.bin.
+    struct SceneRecord
+    {
+        int32_t objectType;
+        float positionX;
+        float positionY;
+        float positionZ;
+    };
+
+    // Loads the scene records, recompiling the binary from the text
+    // file first when the text is newer. Returns false (with an empty
+    // record list) when neither file is usable; the caller falls back
+    // to its built-in layout.
+    static bool LoadScene(
+        const char* textPath,
+        const char* binaryPath,
+        std::vector<SceneRecord>& records);
+
+private:
+    static bool CompileTextToBinary(const char* textPath, const char* binaryPath);
+    static bool ReadBinary(const char* binaryPath, std::vector<SceneRecord>& records);
+};
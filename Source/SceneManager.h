@@ -9,10 +9,15 @@
 
 #pragma once
 
+#include "SceneFile.h"
 #include "ShaderManager.h"
 #include "ShapeMeshes.h"
+#include "StreamingBuffer.h"
+#include "UniformCache.h"
 
+#include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
 /***********************************************************
@@ -35,38 +40,196 @@ public:
         uint32_t ID;
     };
 
-    struct OBJECT_MATERIAL
+    // Dense handle into the material registry; assigned in
+    // registration order.
+    typedef int MaterialId;
+
+    // Packed material values, exactly what the shader uploads. Tags
+    // live in a side array so the hot path never touches a string.
+    struct MaterialData
     {
-        float ambientStrength;
         glm::vec3 ambientColor;
+        float ambientStrength;
         glm::vec3 diffuseColor;
         glm::vec3 specularColor;
         float shininess;
-        std::string tag;
+    };
+
+    // CPU-side mirror of the shader LightSource struct fields I upload.
+    struct LightSourceCPU
+    {
+        glm::vec3 position;
+        glm::vec3 ambientColor;
+        glm::vec3 diffuseColor;
+        glm::vec3 specularColor;
+        float focalStrength;
+        float specularIntensity;
+    };
+
+    // Primitive meshes the shape library can draw.
+    enum class MeshID
+    {
+        Plane,
+        Cylinder,
+        Torus,
+        Box,
+        Sphere
+    };
+
+    // Material presets used by the scene (applied by enum at submit time).
+    enum class MaterialPreset
+    {
+        Stainedglass,
+        Rubber,
+        Wood,
+        Metal,
+        Brick
+    };
+
+    // One precompiled draw. Everything the submit loop needs is resolved
+    // once at record time: composed model matrix, texture slot, material.
+    // The sort key groups identical-state draws so the submit loop can
+    // skip redundant texture/material uniform uploads.
+    //
+    // Static objects (everything in the current scene) keep their
+    // composed matrix forever. Dynamic objects also keep the source
+    // scale/rotation/position so UpdateDynamicTransforms() can recompose
+    // just those each frame when something animates.
+    struct RenderCommand
+    {
+        MeshID mesh;
+        glm::mat4 model;
+        int textureSlot;
+        glm::vec2 uvScale;
+        MaterialPreset material;
+        uint32_t sortKey;
+        bool isStatic;
+        glm::vec3 scaleXYZ;
+        glm::vec3 rotationDegreesXYZ;
+        glm::vec3 positionXYZ;
+        // conservative bounding-sphere radius around positionXYZ,
+        // computed at record time from the mesh and its scale
+        float boundingRadius;
+        // bit i set = light i contributes to this draw; uploaded per
+        // draw so the shader can skip lights that cannot matter
+        uint32_t lightMask;
     };
 
 public:
     void PrepareScene();
     void RenderScene();
 
+    // Updates one light and re-uploads only that light's uniforms.
+    // Lets an animated light change without touching the other three.
+    void SetLight(int index, const LightSourceCPU& light);
+
+    // Eye position for the current frame, passed in from ViewManager
+    // each frame; drives the camera-distance detail culling.
+    void SetCameraPosition(glm::vec3 position);
+
+    // Combined projection * view for the current frame, passed in from
+    // ViewManager; the frustum cull planes are extracted from it.
+    void SetViewProjection(const glm::mat4& viewProjection);
+
+    // On-demand rendering: returns true (and clears the flag) when the
+    // scene content changed since the last call.
+    bool ConsumeSceneDirty();
+
 private:
     ShaderManager* m_pShaderManager;
-    ShapeMeshes* m_basicMeshes;
+    std::unique_ptr<ShapeMeshes> m_basicMeshes;
 
+    // Loaded textures, indexed by slot handle. All draws sample through
+    // texture unit 0 and the slot's texture is bound there per batch,
+    // so the count is not limited by the GL texture unit count.
     int m_loadedTextures;
-    TEXTURE_INFO m_textureIDs[16];
-    std::vector<OBJECT_MATERIAL> m_objectMaterials;
+    std::vector<TEXTURE_INFO> m_textureIDs;
+
+    // Handle-based uniform upload path (names resolved once in PrepareScene)
+    UniformCache m_uniforms;
+    int m_hModel;
+    int m_hObjectColor;
+    int m_hUseTexture;
+    int m_hUseLighting;
+    int m_hTexture;
+    int m_hUVScale;
+    int m_hMaterialAmbientColor;
+    int m_hMaterialAmbientStrength;
+    int m_hMaterialDiffuseColor;
+    int m_hMaterialSpecularColor;
+    int m_hMaterialShininess;
+    int m_hLightPosition[4];
+    int m_hLightAmbientColor[4];
+    int m_hLightDiffuseColor[4];
+    int m_hLightSpecularColor[4];
+    int m_hLightFocalStrength[4];
+    int m_hLightSpecularIntensity[4];
+    // light-loop trimming uniforms; the current course shader does not
+    // declare them yet, so these resolve to no-op handles until it does
+    int m_hActiveLightCount;
+    int m_hLightMask;
+
+    // resolves every uniform name the scene uploads into handles
+    void ResolveShaderHandles();
+
+    // Decoded image pixels handed from a worker thread to the GL upload
+    // stage. mipLevels[0] is the full-resolution image; the rest of the
+    // chain comes either from the texture cache or a CPU box filter.
+    // A failed load leaves mipLevels empty.
+    struct DecodedImage
+    {
+        std::string filename;
+        std::string tag;
+        int width;
+        int height;
+        int channels;
+        std::vector<std::vector<unsigned char>> mipLevels;
+    };
 
     // Texture utilities
-    bool CreateGLTexture(const char* filename, std::string tag);
+    // CreateGLTexture returns a small integer handle (the texture slot);
+    // the hot path uses the handle as an array index, never the tag.
+    // Decode (thread-safe, no GL) and upload (main thread) are separate
+    // stages so startup can decode all scene textures in parallel.
+    static DecodedImage DecodeImageFile(const char* filename, const std::string& tag);
+    int CreateGLTextureFromImage(const DecodedImage& image);
+    int CreateGLTexture(const char* filename, const std::string& tag);
+    void LoadSceneTextures();
     void BindGLTextures();
+    void BindTextureSlot(int textureSlot);
     void DestroyGLTextures();
-    int FindTextureID(std::string tag);
-    int FindTextureSlot(std::string tag);
+    int FindTextureID(std::string_view tag);
+    int FindTextureSlot(std::string_view tag);
+
+    // Handles for the textures PrepareScene() loads, kept so the Build*
+    // functions never resolve a tag per draw.
+    int m_texWood;
+    int m_texStainedglass;
+    int m_texRubber;
+    int m_texStainless;
+    int m_texStainlessEnd;
+    int m_texRusticwood;
+    int m_texGold;
+    int m_texBackdrop;
+
+    // Material registry: values packed contiguously and addressed by
+    // dense id, tags in a parallel side array for cold-path lookup.
+    std::vector<MaterialData> m_materials;
+    std::vector<std::string> m_materialTags;
+
+    // ids of the built-in presets, indexed by MaterialPreset
+    MaterialId m_presetMaterialIds[5];
+
+    MaterialId RegisterMaterial(std::string_view tag, const MaterialData& data);
+    MaterialId FindMaterialId(std::string_view tag) const;
+    void RegisterPresetMaterials();
+
+    // Uploads one registered material: an indexed lookup plus the five
+    // handle-based uniform uploads, no search and no copy.
+    void ApplyMaterial(MaterialId materialId);
 
-    // Material utilities (optional tag-based materials)
-    bool FindMaterial(std::string tag, OBJECT_MATERIAL& material);
-    void SetShaderMaterial(std::string materialTag);
+    // tag-based convenience path (cold; resolves the tag then applies)
+    void SetShaderMaterial(std::string_view materialTag);
 
     // Transform + render state utilities
     void SetTransformations(
@@ -75,22 +238,155 @@ private:
         float YrotationDegrees,
         float ZrotationDegrees,
         glm::vec3 positionXYZ);
+    // overload for a matrix that was already composed and cached
+    void SetTransformations(const glm::mat4& modelMatrix);
 
     void SetShaderColor(float red, float green, float blue, float alpha);
-    void SetShaderTexture(std::string textureTag);
+    void SetShaderTexture(int textureHandle);
+    void SetShaderTexture(std::string_view textureTag);
     void SetTextureUVScale(float u, float v);
 
     // Lighting
+    LightSourceCPU m_sceneLights[4];
     void SetSceneLights();
+    void UploadLight(int index);
+
+    // bitmask of the lights that actually contribute anything;
+    // recomputed whenever a light changes
+    uint32_t m_activeLightMask;
+
+    // recomputes the active mask/count and uploads both uniforms
+    void UploadActiveLightInfo();
+
+    // Applies a built-in preset through its registered material id
+    void ApplyMaterialPreset(MaterialPreset material);
+
+    // Retained draw list, recorded once in PrepareScene() and then
+    // sorted by render state so identical-state draws are contiguous
+    std::vector<RenderCommand> m_drawList;
+
+    void SortDrawList();
+
+    // Contiguous run of same-mesh draws inside the submission list.
+    // This is the CPU analog of one DrawElementsIndirect command: when
+    // the shape library packs its meshes into a shared VBO/EBO, each
+    // batch converts 1:1 into an indirect command and the replay loop
+    // collapses into a single glMultiDrawElementsIndirect call.
+    struct MeshBatch
+    {
+        MeshID mesh;
+        size_t first;
+        size_t count;
+    };
+
+    // Per-frame submission command buffer: indices of the visible
+    // draws, packed contiguously, plus the batch ranges over them.
+    // Both vectors keep their capacity across frames so the fill
+    // phase allocates nothing in steady state.
+    std::vector<size_t> m_submissionList;
+    std::vector<MeshBatch> m_meshBatches;
+
+    // Per-worker output arenas for the parallel record phase. Each
+    // worker culls one contiguous chunk of the draw list into its own
+    // arena; the serial merge then concatenates them in chunk order,
+    // so the submitted order matches the serial path exactly. Kept as
+    // members so their capacity survives across frames.
+    std::vector<std::vector<size_t>> m_cullArenas;
+    std::vector<unsigned long long> m_cullArenaCulled;
+
+    // Fill phase: culls the retained draw list and writes the packed
+    // command buffer that the replay phase in RenderScene() walks.
+    void BuildSubmissionList();
+
+    // One record of the per-frame transform stream: 80 bytes, laid
+    // out to match an std430 block so a shader can index it directly.
+    struct StreamedTransform
+    {
+        glm::mat4 model;
+        int32_t materialId;
+        int32_t padding[3];
+    };
+
+    // Persistent-mapped triple-buffered stream of the visible draws'
+    // transforms and material ids, written with one memcpy pass per
+    // frame and bound as shader storage. The course shader still
+    // reads the model matrix from its uniform, so nothing consumes
+    // the stream yet; it is the upload path the instancing and
+    // indirect-draw work index into.
+    StreamingBuffer m_transformStream;
+
+    // stages the visible commands into the stream; returns false
+    // when the stream is off (no ARB_buffer_storage)
+    bool StreamFrameTransforms();
+
+    glm::mat4 ComposeModelMatrix(
+        glm::vec3 scaleXYZ,
+        float XrotationDegrees,
+        float YrotationDegrees,
+        float ZrotationDegrees,
+        glm::vec3 positionXYZ);
+
+    void RecordDraw(
+        MeshID mesh,
+        glm::vec3 scaleXYZ,
+        float XrotationDegrees,
+        float YrotationDegrees,
+        float ZrotationDegrees,
+        glm::vec3 positionXYZ,
+        int textureHandle,
+        float uvScaleU,
+        float uvScaleV,
+        MaterialPreset material,
+        bool isStatic = true,
+        uint32_t lightMask = 0xFFFFFFFFu);
+
+    // recomposes the model matrix of dynamic commands only; a no-op
+    // while the whole scene is static
+    void UpdateDynamicTransforms();
+
+    // SoA staging for the batch transform kernel: the dynamic
+    // commands' tuples are gathered here each frame, all matrices
+    // composed in one kernel pass, then scattered back into the
+    // draw list. Capacity survives across frames.
+    std::vector<float> m_soaScaleX;
+    std::vector<float> m_soaScaleY;
+    std::vector<float> m_soaScaleZ;
+    std::vector<float> m_soaRotationX;
+    std::vector<float> m_soaRotationY;
+    std::vector<float> m_soaRotationZ;
+    std::vector<float> m_soaPositionX;
+    std::vector<float> m_soaPositionY;
+    std::vector<float> m_soaPositionZ;
+    std::vector<size_t> m_soaCommandIndex;
+    std::vector<glm::mat4> m_soaModels;
+
+    // eye position for the current frame (detail culling distance tests)
+    glm::vec3 m_cameraPosition;
+
+    // six frustum planes (xyz = normal, w = distance) extracted from
+    // the view-projection matrix each frame
+    glm::vec4 m_frustumPlanes[6];
+    bool m_bFrustumValid;
+
+    // per-run cull statistics, reported at shutdown
+    unsigned long long m_drawsVisible;
+    unsigned long long m_drawsCulled;
+
+    // damage flag for on-demand rendering; set by scene mutations
+    bool m_bSceneDirty;
+
+    // returns true when the bounding sphere is at least partly inside
+    // the view frustum
+    bool SphereInFrustum(glm::vec3 center, float radius) const;
 
-    // Material presets (simple, reusable uniform setters)
-    void ApplystainedglassMaterial();
-    void ApplyRubberMaterial();
-    void ApplyWoodMaterial();
-    void ApplyMetalMaterial();
-    void ApplyBrickMaterial();
+    void DrawMesh(MeshID mesh);
 
-    // Object builders
+    // Object builders (record into the draw list)
+    void BuildSceneLayout();
+    void BuildSceneObject(const SceneFile::SceneRecord& record);
+    void BuildDefaultLayout();
+    void BuildFloor(glm::vec3 positionXYZ);
+    void BuildSphere(glm::vec3 positionXYZ);
     void BuildMug(glm::vec3 positionXYZ);
     void BuildCan(glm::vec3 positionXYZ);
     void BuildCoaster(glm::vec3 positionXYZ);
@@ -0,0 +1,236 @@
+///////////////////////////////////////////////////////////////////////////////
+// ShaderBinaryCache.cpp
+//
+// Program binary caching keyed by GLSL source content and driver identity.
+// Cache file layout: { magic, version, key, binaryFormat, binaryLength }
+// followed by the raw program binary.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ShaderBinaryCache.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+    constexpr const char* kCacheFileName = "shaderprogram.cache";
+
+    constexpr uint32_t kCacheMagic = 0x31435053;  // 'SPC1'
+    constexpr uint32_t kCacheVersion = 1;
+
+    struct CacheHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t key;
+        uint32_t binaryFormat;
+        uint32_t binaryLength;
+    };
+
+    // FNV-1a, folded over source files and driver strings below.
+    uint64_t HashBytes(uint64_t hash, const void* data, size_t size)
+    {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i)
+        {
+            hash ^= bytes[i];
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+
+    uint64_t HashFile(uint64_t hash, const char* path)
+    {
+        FILE* file = fopen(path, "rb");
+        if (!file)
+        {
+            // A missing source still contributes, so the key changes when
+            // the file appears later.
+            return HashBytes(hash, "<missing>", 9);
+        }
+
+        unsigned char buffer[4096];
+        size_t bytesRead = 0;
+        while ((bytesRead = fread(buffer, 1, sizeof(buffer), file)) > 0)
+        {
+            hash = HashBytes(hash, buffer, bytesRead);
+        }
+
+        fclose(file);
+        return hash;
+    }
+
+    uint64_t HashGLString(uint64_t hash, GLenum name)
+    {
+        const GLubyte* value = glGetString(name);
+        if (value)
+        {
+            size_t length = 0;
+            while (value[length] != 0)
+            {
+                ++length;
+            }
+            hash = HashBytes(hash, value, length);
+        }
+        return hash;
+    }
+
+    // Cache key: both GLSL sources plus the driver identity. A program
+    // binary is only valid for the driver that produced it.
+    uint64_t ComputeKey(const char* vertexPath, const char* fragmentPath)
+    {
+        uint64_t hash = 14695981039346656037ULL;  // FNV offset basis
+
+        hash = HashFile(hash, vertexPath);
+        hash = HashFile(hash, fragmentPath);
+        hash = HashGLString(hash, GL_VENDOR);
+        hash = HashGLString(hash, GL_RENDERER);
+        hash = HashGLString(hash, GL_VERSION);
+
+        return hash;
+    }
+
+    // true when the driver supports at least one program binary format
+    bool BinaryFormatsSupported()
+    {
+        GLint formatCount = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+        return formatCount > 0;
+    }
+}
+
+/***********************************************************
+ *  TryLoadProgram()
+ ***********************************************************/
+GLuint ShaderBinaryCache::TryLoadProgram(const char* vertexPath, const char* fragmentPath)
+{
+    if (!BinaryFormatsSupported())
+    {
+        return 0;
+    }
+
+    FILE* file = fopen(kCacheFileName, "rb");
+    if (!file)
+    {
+        return 0;
+    }
+
+    CacheHeader header{};
+    if (fread(&header, sizeof(header), 1, file) != 1 ||
+        header.magic != kCacheMagic ||
+        header.version != kCacheVersion ||
+        header.binaryLength == 0)
+    {
+        fclose(file);
+        return 0;
+    }
+
+    // stale when the shader sources or the driver changed
+    if (header.key != ComputeKey(vertexPath, fragmentPath))
+    {
+        fclose(file);
+        return 0;
+    }
+
+    std::vector<unsigned char> binary(header.binaryLength);
+    const bool readOK =
+        (fread(binary.data(), 1, binary.size(), file) == binary.size());
+    fclose(file);
+
+    if (!readOK)
+    {
+        return 0;
+    }
+
+    GLuint programID = glCreateProgram();
+    glProgramBinary(
+        programID,
+        static_cast<GLenum>(header.binaryFormat),
+        binary.data(),
+        static_cast<GLsizei>(binary.size()));
+
+    // Drivers may reject binaries after an update even when the version
+    // string is unchanged, so the link status is the final check.
+    GLint linkStatus = 0;
+    glGetProgramiv(programID, GL_LINK_STATUS, &linkStatus);
+    if (linkStatus != GL_TRUE)
+    {
+        glDeleteProgram(programID);
+        return 0;
+    }
+
+    glUseProgram(programID);
+
+    std::cout << "INFO: shader program restored from binary cache" << std::endl;
+    return programID;
+}
+
+/***********************************************************
+ *  SaveActiveProgram()
+ ***********************************************************/
+void ShaderBinaryCache::SaveActiveProgram(const char* vertexPath, const char* fragmentPath)
+{
+    if (!BinaryFormatsSupported())
+    {
+        return;
+    }
+
+    GLint currentProgram = 0;
+    glGetIntegerv(GL_CURRENT_PROGRAM, &currentProgram);
+    if (currentProgram == 0)
+    {
+        return;
+    }
+
+    GLint binaryLength = 0;
+    glGetProgramiv(currentProgram, GL_PROGRAM_BINARY_LENGTH, &binaryLength);
+    if (binaryLength <= 0)
+    {
+        return;
+    }
+
+    std::vector<unsigned char> binary(binaryLength);
+    GLenum binaryFormat = 0;
+    GLsizei bytesWritten = 0;
+    glGetProgramBinary(
+        currentProgram,
+        binaryLength,
+        &bytesWritten,
+        &binaryFormat,
+        binary.data());
+
+    if (bytesWritten <= 0)
+    {
+        return;
+    }
+
+    CacheHeader header{};
+    header.magic = kCacheMagic;
+    header.version = kCacheVersion;
+    header.key = ComputeKey(vertexPath, fragmentPath);
+    header.binaryFormat = static_cast<uint32_t>(binaryFormat);
+    header.binaryLength = static_cast<uint32_t>(bytesWritten);
+
+    FILE* file = fopen(kCacheFileName, "wb");
+    if (!file)
+    {
+        std::cout << "ShaderBinaryCache: could not write " << kCacheFileName << std::endl;
+        return;
+    }
+
+    bool ok = (fwrite(&header, sizeof(header), 1, file) == 1);
+    if (ok)
+    {
+        ok = (fwrite(binary.data(), 1, bytesWritten, file)
+            == static_cast<size_t>(bytesWritten));
+    }
+    fclose(file);
+
+    if (!ok)
+    {
+        std::cout << "ShaderBinaryCache: write failed" << std::endl;
+        remove(kCacheFileName);
+    }
+}
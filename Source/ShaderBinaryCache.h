@@ -0,0 +1,35 @@
+///////////////////////////////////////////////////////////////////////////////
+// ShaderBinaryCache.h
+// ===================
+// Cache the linked shader program binary so warm startups skip compilation.
+//
+// First run: ShaderManager compiles and links the GLSL sources as usual and
+// the linked binary is saved with glGetProgramBinary. Later runs restore it
+// with glProgramBinary and never touch the compiler. The cache is keyed by a
+// hash of both GLSL source files plus the GL vendor/renderer/version strings,
+// so editing a shader or swapping the driver transparently recompiles.
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+
+/***********************************************************
+ *  ShaderBinaryCache
+ *
+ *  Static helpers around glGetProgramBinary/glProgramBinary.
+ *  Requires a current GL context and initialized GLEW.
+ ***********************************************************/
+class ShaderBinaryCache
+{
+public:
+    // Tries to restore a cached program for the given shader sources.
+    // On a hit the program is linked, made current, and its id returned.
+    // Returns 0 on any miss (no file, stale key, driver rejected binary).
+    static GLuint TryLoadProgram(const char* vertexPath, const char* fragmentPath);
+
+    // Saves the currently bound program's binary, keyed to the given
+    // shader sources and the active driver. Failures are non-fatal; the
+    // only cost is a recompile on the next launch.
+    static void SaveActiveProgram(const char* vertexPath, const char* fragmentPath);
+};
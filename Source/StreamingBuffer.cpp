@@ -0,0 +1,218 @@
+///////////////////////////////////////////////////////////////////////////////
+// streamingbuffer.cpp
+// ===================
+// persistent-mapped triple-buffered streaming buffer. The coherent
+// mapping means CPU writes become visible to the GPU without explicit
+// flushes; the only synchronization is one fence per region, checked
+// when the region comes around again three frames later - by which
+// time it has virtually always signaled.
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include "StreamingBuffer.h"
+
+#include <GL/glew.h>
+
+#include <iostream>
+
+/***********************************************************
+ *  StreamingBuffer()
+ ***********************************************************/
+StreamingBuffer::StreamingBuffer()
+{
+    m_bufferID = 0;
+    m_mappedBase = nullptr;
+    m_regionBytes = 0;
+
+    for (int i = 0; i < kRegionCount; ++i)
+    {
+        m_regionFences[i] = nullptr;
+    }
+    m_currentRegion = 0;
+
+    m_fenceWaits = 0;
+    m_framesStreamed = 0;
+
+    m_bInitialized = false;
+}
+
+/***********************************************************
+ *  Initialize()
+ *
+ *  Creates the immutable buffer store (three regions) and maps
+ *  it persistently. On any failure the buffer stays off and the
+ *  caller keeps using the uniform upload path.
+ ***********************************************************/
+bool StreamingBuffer::Initialize(size_t regionBytes)
+{
+    if (regionBytes == 0)
+    {
+        return false;
+    }
+
+    if (!GLEW_ARB_buffer_storage)
+    {
+        std::cout << "StreamingBuffer: ARB_buffer_storage not available, "
+            << "keeping the uniform upload path" << std::endl;
+        return false;
+    }
+
+    m_regionBytes = regionBytes;
+    const size_t totalBytes = regionBytes * kRegionCount;
+
+    const GLbitfield storageFlags =
+        GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+    glGenBuffers(1, &m_bufferID);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_bufferID);
+    glBufferStorage(GL_SHADER_STORAGE_BUFFER, totalBytes, nullptr, storageFlags);
+
+    m_mappedBase = static_cast<unsigned char*>(glMapBufferRange(
+        GL_SHADER_STORAGE_BUFFER, 0, totalBytes, storageFlags));
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    if (m_mappedBase == nullptr)
+    {
+        std::cout << "StreamingBuffer: persistent map failed" << std::endl;
+        glDeleteBuffers(1, &m_bufferID);
+        m_bufferID = 0;
+        return false;
+    }
+
+    m_bInitialized = true;
+
+    std::cout << "INFO: streaming buffer mapped, 3 x "
+        << regionBytes << " bytes" << std::endl;
+
+    return true;
+}
+
+/***********************************************************
+ *  BeginFrame()
+ *
+ *  Returns the write pointer for this frame's region. The fence
+ *  from the region's previous use is three frames old, so the
+ *  wait is almost always a zero-cost signaled check.
+ ***********************************************************/
+unsigned char* StreamingBuffer::BeginFrame()
+{
+    if (!m_bInitialized)
+    {
+        return nullptr;
+    }
+
+    GLsync fence = static_cast<GLsync>(m_regionFences[m_currentRegion]);
+    if (fence != nullptr)
+    {
+        GLenum waitResult = glClientWaitSync(fence, 0, 0);
+        if ((waitResult != GL_ALREADY_SIGNALED) &&
+            (waitResult != GL_CONDITION_SATISFIED))
+        {
+            // the GPU is still reading this region; wait it out
+            m_fenceWaits++;
+            do
+            {
+                waitResult = glClientWaitSync(
+                    fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);  // 1 ms slices
+            } while ((waitResult != GL_ALREADY_SIGNALED) &&
+                (waitResult != GL_CONDITION_SATISFIED) &&
+                (waitResult != GL_WAIT_FAILED));
+        }
+        glDeleteSync(fence);
+        m_regionFences[m_currentRegion] = nullptr;
+    }
+
+    return m_mappedBase + (static_cast<size_t>(m_currentRegion) * m_regionBytes);
+}
+
+/***********************************************************
+ *  RegionBytes()
+ ***********************************************************/
+size_t StreamingBuffer::RegionBytes() const
+{
+    return m_regionBytes;
+}
+
+/***********************************************************
+ *  BindToShaderStorage()
+ *
+ *  Binds this frame's region to an indexed binding point so a
+ *  shader can index the streamed records.
+ ***********************************************************/
+void StreamingBuffer::BindToShaderStorage(unsigned int bindingIndex) const
+{
+    if (!m_bInitialized)
+    {
+        return;
+    }
+
+    glBindBufferRange(
+        GL_SHADER_STORAGE_BUFFER, bindingIndex, m_bufferID,
+        static_cast<GLintptr>(m_currentRegion) * static_cast<GLintptr>(m_regionBytes),
+        static_cast<GLsizeiptr>(m_regionBytes));
+}
+
+/***********************************************************
+ *  EndFrame()
+ *
+ *  Drops a fence behind this frame's draws and rotates to the
+ *  next region.
+ ***********************************************************/
+void StreamingBuffer::EndFrame()
+{
+    if (!m_bInitialized)
+    {
+        return;
+    }
+
+    m_regionFences[m_currentRegion] =
+        glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    m_currentRegion = (m_currentRegion + 1) % kRegionCount;
+    m_framesStreamed++;
+}
+
+/***********************************************************
+ *  DumpStats()
+ ***********************************************************/
+void StreamingBuffer::DumpStats() const
+{
+    if (!m_bInitialized)
+    {
+        return;
+    }
+
+    std::cout << "STREAM: frames " << m_framesStreamed
+        << ", region bytes " << m_regionBytes
+        << ", fence waits " << m_fenceWaits << std::endl;
+}
+
+/***********************************************************
+ *  Shutdown()
+ ***********************************************************/
+void StreamingBuffer::Shutdown()
+{
+    if (!m_bInitialized)
+    {
+        return;
+    }
+
+    for (int i = 0; i < kRegionCount; ++i)
+    {
+        if (m_regionFences[i] != nullptr)
+        {
+            glDeleteSync(static_cast<GLsync>(m_regionFences[i]));
+            m_regionFences[i] = nullptr;
+        }
+    }
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_bufferID);
+    glUnmapBuffer(GL_SHADER_STORAGE_BUFFER);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    glDeleteBuffers(1, &m_bufferID);
+
+    m_bufferID = 0;
+    m_mappedBase = nullptr;
+    m_bInitialized = false;
+}
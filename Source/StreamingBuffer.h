@@ -0,0 +1,68 @@
+///////////////////////////////////////////////////////////////////////////////
+// streamingbuffer.h
+// =================
+// persistent-mapped triple-buffered GPU streaming buffer. The buffer
+// is created once with glBufferStorage and mapped for the lifetime of
+// the program (GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT), so
+// per-frame data streams in with plain memcpy - no glBufferSubData,
+// no map/unmap, no driver synchronization on the upload. Three
+// regions rotate per frame with a fence guarding each one, so the CPU
+// never writes a region the GPU might still be reading.
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+
+class StreamingBuffer
+{
+public:
+    StreamingBuffer();
+
+    // allocates and persistently maps three regions of regionBytes
+    // each. Requires a current context and ARB_buffer_storage; on a
+    // driver without it the buffer stays off and BeginFrame returns
+    // null, so callers fall back to the uniform upload path.
+    bool Initialize(size_t regionBytes);
+
+    // waits (rarely) on the fence guarding this frame's region and
+    // returns its write pointer, or null when the buffer is off
+    unsigned char* BeginFrame();
+
+    // bytes available in one region
+    size_t RegionBytes() const;
+
+    // binds this frame's region to an indexed shader-storage binding
+    // point so shaders can index into the streamed data
+    void BindToShaderStorage(unsigned int bindingIndex) const;
+
+    // fences the region just written and rotates to the next one;
+    // call after the draws that read from the region were issued
+    void EndFrame();
+
+    // prints region size and how often BeginFrame actually waited
+    void DumpStats() const;
+
+    // unmaps and deletes the buffer; safe to call without Initialize
+    void Shutdown();
+
+private:
+    static const int kRegionCount = 3;
+
+    unsigned int m_bufferID;
+    unsigned char* m_mappedBase;     // persistent mapping, all regions
+    size_t m_regionBytes;
+
+    void* m_regionFences[kRegionCount];   // GLsync, opaque here
+    int m_currentRegion;
+
+    // how often the fence was still unsignaled in BeginFrame; a
+    // rising count means the GPU is more than two frames behind
+    unsigned long long m_fenceWaits;
+    unsigned long long m_framesStreamed;
+
+    bool m_bInitialized;
+};
@@ -0,0 +1,242 @@
+///////////////////////////////////////////////////////////////////////////////
+// TextureCache.cpp
+//
+// Reads and writes the .texcache binary format and builds CPU mip chains.
+// See TextureCache.h for the file layout.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "TextureCache.h"
+
+#include <sys/stat.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+
+namespace
+{
+    constexpr uint32_t kCacheMagic = 0x31435854;  // 'TXC1'
+    constexpr uint32_t kCacheVersion = 1;
+
+    // Fixed-size header at the front of every cache file.
+    struct CacheHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        int32_t width;
+        int32_t height;
+        int32_t channels;
+        int32_t mipCount;
+    };
+
+    // Returns the file modification time, or -1 when the file is missing.
+    long long FileModTime(const char* path)
+    {
+        struct stat info;
+        if (stat(path, &info) != 0)
+        {
+            return -1;
+        }
+        return static_cast<long long>(info.st_mtime);
+    }
+}
+
+/***********************************************************
+ *  CachePathFor()
+ ***********************************************************/
+std::string TextureCache::CachePathFor(const char* sourcePath)
+{
+    return std::string(sourcePath) + ".texcache";
+}
+
+/***********************************************************
+ *  IsCacheFresh()
+ *
+ *  The cache is usable when it exists and the source image has
+ *  not been modified since the cache was written.
+ ***********************************************************/
+bool TextureCache::IsCacheFresh(const char* sourcePath, const std::string& cachePath)
+{
+    const long long sourceTime = FileModTime(sourcePath);
+    const long long cacheTime = FileModTime(cachePath.c_str());
+
+    if (cacheTime < 0)
+    {
+        return false;
+    }
+
+    // A missing source with an existing cache still counts as fresh, so
+    // deployments can ship only the cache files.
+    return (sourceTime < 0) || (cacheTime >= sourceTime);
+}
+
+/***********************************************************
+ *  Load()
+ ***********************************************************/
+bool TextureCache::Load(
+    const std::string& cachePath,
+    int& width,
+    int& height,
+    int& channels,
+    std::vector<std::vector<unsigned char>>& mipLevels)
+{
+    width = 0;
+    height = 0;
+    channels = 0;
+    mipLevels.clear();
+
+    FILE* file = fopen(cachePath.c_str(), "rb");
+    if (!file)
+    {
+        return false;
+    }
+
+    CacheHeader header{};
+    if (fread(&header, sizeof(header), 1, file) != 1 ||
+        header.magic != kCacheMagic ||
+        header.version != kCacheVersion ||
+        header.width <= 0 || header.height <= 0 ||
+        (header.channels != 3 && header.channels != 4) ||
+        header.mipCount <= 0)
+    {
+        fclose(file);
+        return false;
+    }
+
+    int levelWidth = header.width;
+    int levelHeight = header.height;
+
+    mipLevels.resize(header.mipCount);
+    for (int level = 0; level < header.mipCount; ++level)
+    {
+        const size_t levelSize =
+            static_cast<size_t>(levelWidth) * levelHeight * header.channels;
+
+        mipLevels[level].resize(levelSize);
+        if (fread(mipLevels[level].data(), 1, levelSize, file) != levelSize)
+        {
+            // truncated file: treat the whole cache as invalid
+            fclose(file);
+            mipLevels.clear();
+            return false;
+        }
+
+        levelWidth = (levelWidth > 1) ? levelWidth / 2 : 1;
+        levelHeight = (levelHeight > 1) ? levelHeight / 2 : 1;
+    }
+
+    fclose(file);
+
+    width = header.width;
+    height = header.height;
+    channels = header.channels;
+    return true;
+}
+
+/***********************************************************
+ *  Save()
+ ***********************************************************/
+bool TextureCache::Save(
+    const std::string& cachePath,
+    int width,
+    int height,
+    int channels,
+    const std::vector<std::vector<unsigned char>>& mipLevels)
+{
+    FILE* file = fopen(cachePath.c_str(), "wb");
+    if (!file)
+    {
+        std::cout << "TextureCache: could not write: " << cachePath << std::endl;
+        return false;
+    }
+
+    CacheHeader header{};
+    header.magic = kCacheMagic;
+    header.version = kCacheVersion;
+    header.width = width;
+    header.height = height;
+    header.channels = channels;
+    header.mipCount = static_cast<int32_t>(mipLevels.size());
+
+    bool ok = (fwrite(&header, sizeof(header), 1, file) == 1);
+
+    for (size_t level = 0; ok && level < mipLevels.size(); ++level)
+    {
+        ok = (fwrite(mipLevels[level].data(), 1, mipLevels[level].size(), file)
+            == mipLevels[level].size());
+    }
+
+    fclose(file);
+
+    if (!ok)
+    {
+        std::cout << "TextureCache: write failed: " << cachePath << std::endl;
+        remove(cachePath.c_str());
+    }
+
+    return ok;
+}
+
+/***********************************************************
+ *  BuildMipChain()
+ *
+ *  Box-filters mipLevels[0] down to 1x1. Equivalent in quality
+ *  to the glGenerateMipmap default, but done once offline instead
+ *  of on every launch.
+ ***********************************************************/
+void TextureCache::BuildMipChain(
+    int width,
+    int height,
+    int channels,
+    std::vector<std::vector<unsigned char>>& mipLevels)
+{
+    if (mipLevels.empty())
+    {
+        return;
+    }
+
+    mipLevels.resize(1);
+
+    int sourceWidth = width;
+    int sourceHeight = height;
+
+    while (sourceWidth > 1 || sourceHeight > 1)
+    {
+        const int destWidth = (sourceWidth > 1) ? sourceWidth / 2 : 1;
+        const int destHeight = (sourceHeight > 1) ? sourceHeight / 2 : 1;
+
+        const std::vector<unsigned char>& source = mipLevels.back();
+        std::vector<unsigned char> dest(
+            static_cast<size_t>(destWidth) * destHeight * channels);
+
+        for (int y = 0; y < destHeight; ++y)
+        {
+            // clamp so odd dimensions stay in bounds
+            const int sourceY0 = (y * 2 < sourceHeight) ? y * 2 : sourceHeight - 1;
+            const int sourceY1 = (sourceY0 + 1 < sourceHeight) ? sourceY0 + 1 : sourceY0;
+
+            for (int x = 0; x < destWidth; ++x)
+            {
+                const int sourceX0 = (x * 2 < sourceWidth) ? x * 2 : sourceWidth - 1;
+                const int sourceX1 = (sourceX0 + 1 < sourceWidth) ? sourceX0 + 1 : sourceX0;
+
+                for (int c = 0; c < channels; ++c)
+                {
+                    const int sum =
+                        source[(static_cast<size_t>(sourceY0) * sourceWidth + sourceX0) * channels + c] +
+                        source[(static_cast<size_t>(sourceY0) * sourceWidth + sourceX1) * channels + c] +
+                        source[(static_cast<size_t>(sourceY1) * sourceWidth + sourceX0) * channels + c] +
+                        source[(static_cast<size_t>(sourceY1) * sourceWidth + sourceX1) * channels + c];
+
+                    dest[(static_cast<size_t>(y) * destWidth + x) * channels + c] =
+                        static_cast<unsigned char>(sum / 4);
+                }
+            }
+        }
+
+        mipLevels.push_back(std::move(dest));
+
+        sourceWidth = destWidth;
+        sourceHeight = destHeight;
+    }
+}
@@ -0,0 +1,65 @@
+///////////////////////////////////////////////////////////////////////////////
+// TextureCache.h
+// ==============
+// Binary GPU-ready texture cache with precomputed mip chains.
+//
+// First run: the JPEG is decoded, a full mip chain is built on the CPU, and
+// everything is written to a .texcache file next to the source image.
+// Later runs: the cache file is read straight into memory and uploaded level
+// by level, with no JPEG decode and no runtime glGenerateMipmap.
+//
+// File layout (little endian, tightly packed):
+//   CacheHeader { magic 'TXC1', version, width, height, channels, mipCount }
+//   mip level 0 pixels, mip level 1 pixels, ... down to 1x1
+//
+// Pixels are stored uncompressed (RGB8/RGBA8). A block-compressed (BC/DXT)
+// variant would also shrink VRAM, but needs a compressor dependency this
+// project does not carry; the format field in the header leaves room for it.
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+/***********************************************************
+ *  TextureCache
+ *
+ *  Static helpers for the texture cache format. All functions
+ *  are pure CPU/file work, safe to call from decode workers.
+ ***********************************************************/
+class TextureCache
+{
+public:
+    // cache file path for a source image ("Textures/wood.jpg.texcache")
+    static std::string CachePathFor(const char* sourcePath);
+
+    // true when the cache file exists and is newer than the source image
+    static bool IsCacheFresh(const char* sourcePath, const std::string& cachePath);
+
+    // Reads a cache file. Returns false (and leaves outputs empty) on a
+    // missing, truncated, or version-mismatched file.
+    static bool Load(
+        const std::string& cachePath,
+        int& width,
+        int& height,
+        int& channels,
+        std::vector<std::vector<unsigned char>>& mipLevels);
+
+    // Writes a cache file. Failure only costs the rebuild next launch,
+    // so it is reported but not fatal.
+    static bool Save(
+        const std::string& cachePath,
+        int width,
+        int height,
+        int channels,
+        const std::vector<std::vector<unsigned char>>& mipLevels);
+
+    // Builds the rest of the mip chain from mipLevels[0] with a box
+    // filter, halving each axis down to 1x1.
+    static void BuildMipChain(
+        int width,
+        int height,
+        int channels,
+        std::vector<std::vector<unsigned char>>& mipLevels);
+};
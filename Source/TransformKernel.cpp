@@ -0,0 +1,130 @@
+///////////////////////////////////////////////////////////////////////////////
+// transformkernel.cpp
+// ===================
+// batch model-matrix composition from SoA transform tuples.
+//
+// For M = T * Rx * Ry * Rz * S (the order ComposeModelMatrix uses),
+// the combined rotation R = Rx * Ry * Rz expands to:
+//
+//   col0 = ( cy*cz,  sx*sy*cz + cx*sz,  -cx*sy*cz + sx*sz )
+//   col1 = (-cy*sz, -sx*sy*sz + cx*cz,   cx*sy*sz + sx*cz )
+//   col2 = ( sy,    -sx*cy,              cx*cy            )
+//
+// with sx = sin(rotX) etc. The model matrix is then just each column
+// scaled by its axis scale, and the position in column 3 - no 4x4
+// multiplies at all. The SSE path does the column scale/store 4 wide;
+// the scalar fallback produces bit-identical layout on targets
+// without SSE2.
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include "TransformKernel.h"
+
+#include <cmath>
+
+// MSVC: /arch:SSE2 is implied on x64 and reported via _M_IX86_FP on
+// x86; other compilers define __SSE2__ directly.
+#if defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2)) || defined(__SSE2__)
+#define TRANSFORM_KERNEL_SSE2 1
+#include <emmintrin.h>
+#else
+#define TRANSFORM_KERNEL_SSE2 0
+#endif
+
+namespace
+{
+    constexpr float kDegreesToRadians = 0.01745329251994329577f;
+}
+
+/***********************************************************
+ *  ComposeModelMatrices()
+ *
+ *  Composes one model matrix per tuple in [begin, end). The
+ *  range form lets the caller split a big batch across the
+ *  record-phase workers; chunks write disjoint output ranges.
+ ***********************************************************/
+void TransformKernel::ComposeModelMatrices(
+    const TransformBatch& batch,
+    size_t begin,
+    size_t end,
+    glm::mat4* outModels)
+{
+    for (size_t i = begin; i < end; ++i)
+    {
+        const float sx = std::sin(batch.rotationXDegrees[i] * kDegreesToRadians);
+        const float cx = std::cos(batch.rotationXDegrees[i] * kDegreesToRadians);
+        const float sy = std::sin(batch.rotationYDegrees[i] * kDegreesToRadians);
+        const float cy = std::cos(batch.rotationYDegrees[i] * kDegreesToRadians);
+        const float sz = std::sin(batch.rotationZDegrees[i] * kDegreesToRadians);
+        const float cz = std::cos(batch.rotationZDegrees[i] * kDegreesToRadians);
+
+#if TRANSFORM_KERNEL_SSE2
+        float* outColumns = &outModels[i][0][0];
+
+        const __m128 column0 = _mm_mul_ps(
+            _mm_set_ps(0.0f,
+                -cx * sy * cz + sx * sz,
+                sx * sy * cz + cx * sz,
+                cy * cz),
+            _mm_set1_ps(batch.scaleX[i]));
+
+        const __m128 column1 = _mm_mul_ps(
+            _mm_set_ps(0.0f,
+                cx * sy * sz + sx * cz,
+                -sx * sy * sz + cx * cz,
+                -cy * sz),
+            _mm_set1_ps(batch.scaleY[i]));
+
+        const __m128 column2 = _mm_mul_ps(
+            _mm_set_ps(0.0f,
+                cx * cy,
+                -sx * cy,
+                sy),
+            _mm_set1_ps(batch.scaleZ[i]));
+
+        const __m128 column3 = _mm_set_ps(
+            1.0f, batch.positionZ[i], batch.positionY[i], batch.positionX[i]);
+
+        _mm_storeu_ps(outColumns + 0, column0);
+        _mm_storeu_ps(outColumns + 4, column1);
+        _mm_storeu_ps(outColumns + 8, column2);
+        _mm_storeu_ps(outColumns + 12, column3);
+#else
+        glm::mat4& model = outModels[i];
+
+        model[0][0] = (cy * cz) * batch.scaleX[i];
+        model[0][1] = (sx * sy * cz + cx * sz) * batch.scaleX[i];
+        model[0][2] = (-cx * sy * cz + sx * sz) * batch.scaleX[i];
+        model[0][3] = 0.0f;
+
+        model[1][0] = (-cy * sz) * batch.scaleY[i];
+        model[1][1] = (-sx * sy * sz + cx * cz) * batch.scaleY[i];
+        model[1][2] = (cx * sy * sz + sx * cz) * batch.scaleY[i];
+        model[1][3] = 0.0f;
+
+        model[2][0] = sy * batch.scaleZ[i];
+        model[2][1] = (-sx * cy) * batch.scaleZ[i];
+        model[2][2] = (cx * cy) * batch.scaleZ[i];
+        model[2][3] = 0.0f;
+
+        model[3][0] = batch.positionX[i];
+        model[3][1] = batch.positionY[i];
+        model[3][2] = batch.positionZ[i];
+        model[3][3] = 1.0f;
+#endif
+    }
+}
+
+/***********************************************************
+ *  ActivePathName()
+ ***********************************************************/
+const char* TransformKernel::ActivePathName()
+{
+#if TRANSFORM_KERNEL_SSE2
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
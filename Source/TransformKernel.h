@@ -0,0 +1,51 @@
+///////////////////////////////////////////////////////////////////////////////
+// transformkernel.h
+// =================
+// batch model-matrix composition. Instead of building five 4x4
+// matrices and chaining four multiplies per object (the glm path in
+// ComposeModelMatrix), the kernel uses the closed form of
+// translation * rotX * rotY * rotZ * scale: nine rotation terms from
+// the six sines/cosines, columns scaled, position dropped into the
+// last column. Input is structure-of-arrays so the loop streams
+// through memory, and the column math runs through SSE when the
+// target supports it.
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+
+class TransformKernel
+{
+public:
+    // SoA view over the transform tuples; every array must hold at
+    // least `end` entries. The caller owns the storage.
+    struct TransformBatch
+    {
+        const float* scaleX;
+        const float* scaleY;
+        const float* scaleZ;
+        const float* rotationXDegrees;
+        const float* rotationYDegrees;
+        const float* rotationZDegrees;
+        const float* positionX;
+        const float* positionY;
+        const float* positionZ;
+    };
+
+    // composes outModels[i] for i in [begin, end); ranges let the
+    // parallel record phase split one batch across workers
+    static void ComposeModelMatrices(
+        const TransformBatch& batch,
+        size_t begin,
+        size_t end,
+        glm::mat4* outModels);
+
+    // "SSE2" or "scalar", for the startup log
+    static const char* ActivePathName();
+};
@@ -0,0 +1,235 @@
+///////////////////////////////////////////////////////////////////////////////
+// UniformCache.cpp
+//
+// Handle-based uniform upload layer. Names are resolved exactly once with
+// glGetUniformLocation; per-frame uploads are plain glUniform* calls indexed
+// by integer handle.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "UniformCache.h"
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include <cstring>
+#include <iostream>
+
+unsigned long long UniformCache::s_uploadsIssued = 0;
+unsigned long long UniformCache::s_uploadsElided = 0;
+
+/***********************************************************
+ *  UniformCache()
+ ***********************************************************/
+UniformCache::UniformCache()
+    : m_programID(0)
+{
+}
+
+/***********************************************************
+ *  AttachToActiveProgram()
+ *
+ *  Captures the program currently in use so Resolve() queries
+ *  the right one. Any previously resolved handles are dropped.
+ ***********************************************************/
+void UniformCache::AttachToActiveProgram()
+{
+    GLint currentProgram = 0;
+    glGetIntegerv(GL_CURRENT_PROGRAM, &currentProgram);
+
+    if (currentProgram == 0)
+    {
+        std::cout << "UniformCache: no shader program is active" << std::endl;
+    }
+
+    m_programID = static_cast<GLuint>(currentProgram);
+    m_locations.clear();
+    m_shadows.clear();
+}
+
+/***********************************************************
+ *  Resolve()
+ *
+ *  Looks up the uniform location once and returns the handle
+ *  used for all later uploads. A missing name is reported so
+ *  shader/scene mismatches surface at startup.
+ ***********************************************************/
+int UniformCache::Resolve(const char* uniformName)
+{
+    return ResolveInternal(uniformName, true);
+}
+
+/***********************************************************
+ *  ResolveOptional()
+ *
+ *  Resolve() without the missing-uniform report, for names the
+ *  scene code is prepared to run without.
+ ***********************************************************/
+int UniformCache::ResolveOptional(const char* uniformName)
+{
+    return ResolveInternal(uniformName, false);
+}
+
+/***********************************************************
+ *  ResolveInternal()
+ *
+ *  Shared lookup behind both resolve flavors.
+ ***********************************************************/
+int UniformCache::ResolveInternal(const char* uniformName, bool bReportMissing)
+{
+    GLint location = -1;
+
+    if (m_programID != 0)
+    {
+        location = glGetUniformLocation(m_programID, uniformName);
+        if ((location < 0) && bReportMissing)
+        {
+            // Kept as a handle anyway so callers never branch; uploads
+            // through it are ignored, same as glUniform* with -1.
+            std::cout << "UniformCache: uniform not found: " << uniformName << std::endl;
+        }
+    }
+
+    m_locations.push_back(location);
+
+    ShadowValue shadow;
+    shadow.componentCount = 0;
+    m_shadows.push_back(shadow);
+
+    return static_cast<int>(m_locations.size()) - 1;
+}
+
+/***********************************************************
+ *  StoreIfChanged()
+ *
+ *  Compares the value against the shadow copy of the last
+ *  upload. Unchanged values skip the GL call entirely, which
+ *  removes well over half the per-frame uniform traffic.
+ ***********************************************************/
+bool UniformCache::StoreIfChanged(int handle, const float* data, int componentCount)
+{
+    ShadowValue& shadow = m_shadows[handle];
+
+    if ((shadow.componentCount == componentCount) &&
+        (std::memcmp(shadow.data, data, componentCount * sizeof(float)) == 0))
+    {
+        s_uploadsElided++;
+        return false;
+    }
+
+    shadow.componentCount = componentCount;
+    std::memcpy(shadow.data, data, componentCount * sizeof(float));
+    s_uploadsIssued++;
+    return true;
+}
+
+/***********************************************************
+ *  DumpStats()
+ *
+ *  Prints the aggregate uploads issued vs elided.
+ ***********************************************************/
+void UniformCache::DumpStats()
+{
+    unsigned long long total = s_uploadsIssued + s_uploadsElided;
+    std::cout << "UNIFORMS: issued " << s_uploadsIssued
+        << ", elided " << s_uploadsElided;
+    if (total > 0)
+    {
+        std::cout << " (" << (100.0 * s_uploadsElided / total) << "% redundant)";
+    }
+    std::cout << std::endl;
+}
+
+/***********************************************************
+ *  ValidHandle()
+ ***********************************************************/
+bool UniformCache::ValidHandle(int handle) const
+{
+    return (handle >= 0) && (handle < static_cast<int>(m_locations.size()));
+}
+
+/***********************************************************
+ *  Handle-based setters
+ *
+ *  These mirror the ShaderManager setter set used by the scene
+ *  code, minus the per-call string lookup.
+ ***********************************************************/
+void UniformCache::SetIntValue(int handle, int value)
+{
+    if (ValidHandle(handle))
+    {
+        // int bits kept exactly in the float shadow slot
+        float shadowed;
+        std::memcpy(&shadowed, &value, sizeof(float));
+        if (StoreIfChanged(handle, &shadowed, 1))
+        {
+            glUniform1i(m_locations[handle], value);
+        }
+    }
+}
+
+void UniformCache::SetFloatValue(int handle, float value)
+{
+    if (ValidHandle(handle))
+    {
+        if (StoreIfChanged(handle, &value, 1))
+        {
+            glUniform1f(m_locations[handle], value);
+        }
+    }
+}
+
+void UniformCache::SetVec2Value(int handle, glm::vec2 value)
+{
+    if (ValidHandle(handle))
+    {
+        if (StoreIfChanged(handle, glm::value_ptr(value), 2))
+        {
+            glUniform2fv(m_locations[handle], 1, glm::value_ptr(value));
+        }
+    }
+}
+
+void UniformCache::SetVec3Value(int handle, glm::vec3 value)
+{
+    if (ValidHandle(handle))
+    {
+        if (StoreIfChanged(handle, glm::value_ptr(value), 3))
+        {
+            glUniform3fv(m_locations[handle], 1, glm::value_ptr(value));
+        }
+    }
+}
+
+void UniformCache::SetVec4Value(int handle, glm::vec4 value)
+{
+    if (ValidHandle(handle))
+    {
+        if (StoreIfChanged(handle, glm::value_ptr(value), 4))
+        {
+            glUniform4fv(m_locations[handle], 1, glm::value_ptr(value));
+        }
+    }
+}
+
+void UniformCache::SetMat4Value(int handle, const glm::mat4& value)
+{
+    if (ValidHandle(handle))
+    {
+        if (StoreIfChanged(handle, glm::value_ptr(value), 16))
+        {
+            glUniformMatrix4fv(m_locations[handle], 1, GL_FALSE, glm::value_ptr(value));
+        }
+    }
+}
+
+void UniformCache::SetSampler2DValue(int handle, int textureSlot)
+{
+    if (ValidHandle(handle))
+    {
+        float shadowed;
+        std::memcpy(&shadowed, &textureSlot, sizeof(float));
+        if (StoreIfChanged(handle, &shadowed, 1))
+        {
+            glUniform1i(m_locations[handle], textureSlot);
+        }
+    }
+}
@@ -0,0 +1,98 @@
+///////////////////////////////////////////////////////////////////////////////
+// UniformCache.h
+// ==============
+// Resolve shader uniform names once and upload values through integer handles.
+//
+// The provided ShaderManager setters (setVec3Value, setMat4Value, ...) call
+// glGetUniformLocation on every invocation, which makes string lookup the
+// dominant CPU cost in the render loop. This cache captures the active shader
+// program after LoadShaders()/use(), resolves each uniform name exactly once,
+// and hands back a small integer handle for all later uploads.
+//
+// ShaderManager itself lives in the shared course Utilities tree, so the
+// cache is layered on top of it here instead of modifying it directly.
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+/***********************************************************
+ *  UniformCache
+ *
+ *  One-time uniform name resolution plus handle-based setters
+ *  for the render hot path:
+ *  - AttachToActiveProgram() after the shader program is in use
+ *  - Resolve() each uniform name once (e.g. in PrepareScene)
+ *  - Set*Value(handle, ...) every frame with no string work
+ ***********************************************************/
+class UniformCache
+{
+public:
+    UniformCache();
+
+    // Captures the currently bound shader program. Must be called after
+    // ShaderManager::LoadShaders() and use(), before any Resolve() call.
+    void AttachToActiveProgram();
+
+    // Resolves a uniform name to a stable integer handle. A name that does
+    // not exist in the program still returns a handle; uploads through it
+    // become silent no-ops (matching glUniform* behavior for location -1).
+    // A missing name is reported on the console so shader/scene mismatches
+    // surface at startup.
+    int Resolve(const char* uniformName);
+
+    // Same as Resolve() but without the missing-uniform report. For
+    // uniforms the scene code is prepared to run without (e.g. ones a
+    // future shader revision will add), so the startup log only flags
+    // names that are genuinely expected to exist.
+    int ResolveOptional(const char* uniformName);
+
+    // Handle-based setters (no string lookup, no allocation)
+    void SetIntValue(int handle, int value);
+    void SetFloatValue(int handle, float value);
+    void SetVec2Value(int handle, glm::vec2 value);
+    void SetVec3Value(int handle, glm::vec3 value);
+    void SetVec4Value(int handle, glm::vec4 value);
+    void SetMat4Value(int handle, const glm::mat4& value);
+    void SetSampler2DValue(int handle, int textureSlot);
+
+    // Prints uploads issued vs elided across every cache instance.
+    static void DumpStats();
+
+private:
+    // Last value uploaded through a handle; componentCount 0 means no
+    // value has been uploaded yet. Ints are stored bit-for-bit in the
+    // float slots so the comparison is exact.
+    struct ShadowValue
+    {
+        int componentCount;
+        float data[16];
+    };
+
+    // shader program the cached locations belong to
+    GLuint m_programID;
+    // resolved uniform locations, indexed by handle
+    std::vector<GLint> m_locations;
+    // last-uploaded values, indexed by handle
+    std::vector<ShadowValue> m_shadows;
+
+    // shared lookup behind Resolve()/ResolveOptional()
+    int ResolveInternal(const char* uniformName, bool bReportMissing);
+
+    // returns true when the handle maps to a resolved location
+    bool ValidHandle(int handle) const;
+
+    // updates the shadow copy; returns false (and counts an elided
+    // call) when the value is identical to the last upload
+    bool StoreIfChanged(int handle, const float* data, int componentCount);
+
+    // upload traffic counters, shared across instances so the report
+    // covers the scene and view caches together
+    static unsigned long long s_uploadsIssued;
+    static unsigned long long s_uploadsElided;
+};
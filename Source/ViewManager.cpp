@@ -8,6 +8,10 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include "ViewManager.h"
+#include "FramePacer.h"
+#include "GpuProfiler.h"
+#include "RenderTarget.h"
+#include "FrameCapture.h"
 
 #include <cmath> // sin, cos, atan2, asin
 
@@ -38,6 +42,20 @@ namespace
 	float gDeltaTime = 0.0f;
 	float gLastFrame = 0.0f;
 
+	// Fixed-timestep camera simulation. Movement integrates at a
+	// constant 240 Hz regardless of render throughput; whatever
+	// fraction of a step is left over each frame becomes the
+	// interpolation factor between the last two simulated positions,
+	// so motion stays smooth even when rendering stutters.
+	const float kFixedTimestep = 1.0f / 240.0f;
+	// cap the catch-up work after a long stall (load hitch, debugger)
+	// so one bad frame cannot trigger a spiral of fixed steps
+	const float kMaxFrameDelta = 0.25f;
+	float gSimAccumulator = 0.0f;
+	glm::vec3 gPrevSimPosition = glm::vec3(0.0f);
+	// position actually rendered this frame (interpolated)
+	glm::vec3 gRenderPosition = glm::vec3(0.0f);
+
 	// projection mode
 	bool bOrthographicProjection = false;
 
@@ -53,6 +71,14 @@ namespace
 	// one-tap key handling
 	bool gToggleKeyDown_O = false;
 	bool gToggleKeyDown_P = false;
+	bool gToggleKeyDown_F9 = false;
+	bool gToggleKeyDown_F10 = false;
+	bool gToggleKeyDown_F11 = false;
+	bool gToggleKeyDown_F12 = false;
+
+	// damage flag for on-demand rendering; starts dirty so the first
+	// frame always draws
+	bool gViewDirty = true;
 
 	// Orthographic camera settings (aim directly at the 3D object).
 	// These are tuned for your current mug location:
@@ -70,6 +96,12 @@ ViewManager::ViewManager(ShaderManager* pShaderManager)
 	m_pShaderManager = pShaderManager;
 	m_pWindow = NULL;
 
+	m_bHandlesResolved = false;
+	m_hView = -1;
+	m_hProjection = -1;
+	m_hViewPosition = -1;
+	m_viewProjection = glm::mat4(1.0f);
+
 	g_pCamera = new Camera();
 
 	// default camera view parameters
@@ -78,6 +110,11 @@ ViewManager::ViewManager(ShaderManager* pShaderManager)
 	g_pCamera->Up = glm::vec3(0.0f, 1.0f, 0.0f);
 	g_pCamera->Zoom = 80.0f;
 
+	// simulation and render positions start at the camera position
+	gPrevSimPosition = g_pCamera->Position;
+	gRenderPosition = g_pCamera->Position;
+	gSimAccumulator = 0.0f;
+
 	// Initialize yaw and pitch from the default front direction
 	glm::vec3 front = glm::normalize(g_pCamera->Front);
 
@@ -183,6 +220,11 @@ void ViewManager::Mouse_Position_Callback(GLFWwindow* window, double xMousePos,
 		front.y = static_cast<float>(std::sin(glm::radians(gPitch)));
 		front.z = static_cast<float>(std::sin(glm::radians(gYaw)) * std::cos(glm::radians(gPitch)));
 		g_pCamera->Front = glm::normalize(front);
+
+		if ((xoffset != 0.0f) || (yoffset != 0.0f))
+		{
+			gViewDirty = true;
+		}
 	}
 }
 
@@ -219,6 +261,7 @@ void ViewManager::ProcessKeyboardEvents()
 		{
 			bOrthographicProjection = true;
 			gToggleKeyDown_O = true;
+			gViewDirty = true;
 		}
 	}
 	else
@@ -233,6 +276,7 @@ void ViewManager::ProcessKeyboardEvents()
 		{
 			bOrthographicProjection = false;
 			gToggleKeyDown_P = true;
+			gViewDirty = true;
 		}
 	}
 	else
@@ -240,30 +284,212 @@ void ViewManager::ProcessKeyboardEvents()
 		gToggleKeyDown_P = false;
 	}
 
-	// Camera movement only applies in perspective mode
+	// One-tap profiler report dump
+	if (glfwGetKey(m_pWindow, GLFW_KEY_F9) == GLFW_PRESS)
+	{
+		if (!gToggleKeyDown_F9)
+		{
+			GpuProfiler::Instance().DumpReport();
+			UniformCache::DumpStats();
+			gToggleKeyDown_F9 = true;
+		}
+	}
+	else
+	{
+		gToggleKeyDown_F9 = false;
+	}
+
+	// One-tap swap mode cycle (immediate / vsync / adaptive)
+	if (glfwGetKey(m_pWindow, GLFW_KEY_F10) == GLFW_PRESS)
+	{
+		if (!gToggleKeyDown_F10)
+		{
+			FramePacer::Instance().CycleSwapMode();
+			gViewDirty = true;
+			gToggleKeyDown_F10 = true;
+		}
+	}
+	else
+	{
+		gToggleKeyDown_F10 = false;
+	}
+
+	// One-tap render scale mode cycle (auto / 100% / 75% / 50%)
+	if (glfwGetKey(m_pWindow, GLFW_KEY_F11) == GLFW_PRESS)
+	{
+		if (!gToggleKeyDown_F11)
+		{
+			RenderTarget::Instance().CycleScaleMode();
+			gViewDirty = true;
+			gToggleKeyDown_F11 = true;
+		}
+	}
+	else
+	{
+		gToggleKeyDown_F11 = false;
+	}
+
+	// One-tap frame capture; dirtying the view forces a render this
+	// loop iteration so there is a fresh frame to read back
+	if (glfwGetKey(m_pWindow, GLFW_KEY_F12) == GLFW_PRESS)
+	{
+		if (!gToggleKeyDown_F12)
+		{
+			FrameCapture::Instance().RequestCapture();
+			gViewDirty = true;
+			gToggleKeyDown_F12 = true;
+		}
+	}
+	else
+	{
+		gToggleKeyDown_F12 = false;
+	}
+
+	// Camera movement only applies in perspective mode; any held
+	// movement key keeps the frame dirty so the fixed-step
+	// integrator below keeps running
 	if (!bOrthographicProjection)
 	{
-		const float velocity = gBaseMoveSpeed * gSpeedScale * gDeltaTime;
-
-		// Forward and backward
-		if (glfwGetKey(m_pWindow, GLFW_KEY_W) == GLFW_PRESS)
-			g_pCamera->Position += g_pCamera->Front * velocity;
-		if (glfwGetKey(m_pWindow, GLFW_KEY_S) == GLFW_PRESS)
-			g_pCamera->Position -= g_pCamera->Front * velocity;
-
-		// Left and right (strafe)
-		glm::vec3 right = glm::normalize(glm::cross(g_pCamera->Front, g_pCamera->Up));
-		if (glfwGetKey(m_pWindow, GLFW_KEY_A) == GLFW_PRESS)
-			g_pCamera->Position -= right * velocity;
-		if (glfwGetKey(m_pWindow, GLFW_KEY_D) == GLFW_PRESS)
-			g_pCamera->Position += right * velocity;
-
-		// Up and down
-		if (glfwGetKey(m_pWindow, GLFW_KEY_Q) == GLFW_PRESS)
-			g_pCamera->Position += g_pCamera->Up * velocity;
-		if (glfwGetKey(m_pWindow, GLFW_KEY_E) == GLFW_PRESS)
-			g_pCamera->Position -= g_pCamera->Up * velocity;
+		if ((glfwGetKey(m_pWindow, GLFW_KEY_W) == GLFW_PRESS) ||
+			(glfwGetKey(m_pWindow, GLFW_KEY_S) == GLFW_PRESS) ||
+			(glfwGetKey(m_pWindow, GLFW_KEY_A) == GLFW_PRESS) ||
+			(glfwGetKey(m_pWindow, GLFW_KEY_D) == GLFW_PRESS) ||
+			(glfwGetKey(m_pWindow, GLFW_KEY_Q) == GLFW_PRESS) ||
+			(glfwGetKey(m_pWindow, GLFW_KEY_E) == GLFW_PRESS))
+		{
+			gViewDirty = true;
+		}
+	}
+}
+
+/***********************************************************
+ *  IntegrateCameraMovement()
+ *
+ *  Advances the camera by one fixed simulation step from the
+ *  currently held movement keys. Always called with
+ *  kFixedTimestep, so camera velocity is identical at 20 fps
+ *  and at 240 fps.
+ ***********************************************************/
+void ViewManager::IntegrateCameraMovement(float timestep)
+{
+	// movement only applies in perspective mode
+	if (bOrthographicProjection)
+	{
+		return;
+	}
+
+	const float velocity = gBaseMoveSpeed * gSpeedScale * timestep;
+
+	// Forward and backward
+	if (glfwGetKey(m_pWindow, GLFW_KEY_W) == GLFW_PRESS)
+		g_pCamera->Position += g_pCamera->Front * velocity;
+	if (glfwGetKey(m_pWindow, GLFW_KEY_S) == GLFW_PRESS)
+		g_pCamera->Position -= g_pCamera->Front * velocity;
+
+	// Left and right (strafe)
+	glm::vec3 right = glm::normalize(glm::cross(g_pCamera->Front, g_pCamera->Up));
+	if (glfwGetKey(m_pWindow, GLFW_KEY_A) == GLFW_PRESS)
+		g_pCamera->Position -= right * velocity;
+	if (glfwGetKey(m_pWindow, GLFW_KEY_D) == GLFW_PRESS)
+		g_pCamera->Position += right * velocity;
+
+	// Up and down
+	if (glfwGetKey(m_pWindow, GLFW_KEY_Q) == GLFW_PRESS)
+		g_pCamera->Position += g_pCamera->Up * velocity;
+	if (glfwGetKey(m_pWindow, GLFW_KEY_E) == GLFW_PRESS)
+		g_pCamera->Position -= g_pCamera->Up * velocity;
+}
+
+/***********************************************************
+ *  SetCameraPose()
+ *
+ *  Places the camera from script (benchmark camera sweeps). The
+ *  mouse-look angles are re-derived from the new front vector so
+ *  interactive control stays consistent afterwards.
+ ***********************************************************/
+void ViewManager::SetCameraPose(glm::vec3 position, glm::vec3 front)
+{
+	if (NULL == g_pCamera)
+	{
+		return;
+	}
+
+	g_pCamera->Position = position;
+	g_pCamera->Front = glm::normalize(front);
+
+	// scripted poses are absolute: snap the simulation state so no
+	// interpolation blends away from the requested position
+	gPrevSimPosition = position;
+	gRenderPosition = position;
+	gSimAccumulator = 0.0f;
+
+	gYaw = glm::degrees(static_cast<float>(
+		std::atan2(g_pCamera->Front.z, g_pCamera->Front.x)));
+	gPitch = glm::degrees(static_cast<float>(std::asin(g_pCamera->Front.y)));
+
+	gViewDirty = true;
+}
+
+/***********************************************************
+ *  ConsumeViewDirty()
+ *
+ *  Returns whether the view changed since the last call and
+ *  clears the flag. The main loop skips rendering while both
+ *  this and the scene's flag stay clean.
+ ***********************************************************/
+bool ViewManager::ConsumeViewDirty()
+{
+	const bool bWasDirty = gViewDirty;
+	gViewDirty = false;
+	return bWasDirty;
+}
+
+/***********************************************************
+ *  GetCameraPosition()
+ *
+ *  Returns the eye position for the current frame so the scene
+ *  can run camera-distance tests (detail culling).
+ ***********************************************************/
+glm::vec3 ViewManager::GetCameraPosition() const
+{
+	if (bOrthographicProjection)
+	{
+		return gOrthoCamPos;
 	}
+	if (NULL != g_pCamera)
+	{
+		// the interpolated position actually used for this frame's view
+		return gRenderPosition;
+	}
+	return glm::vec3(0.0f);
+}
+
+/***********************************************************
+ *  GetViewProjectionMatrix()
+ *
+ *  Returns projection * view for the frame most recently
+ *  prepared; the scene extracts its culling frustum from it.
+ ***********************************************************/
+glm::mat4 ViewManager::GetViewProjectionMatrix() const
+{
+	return m_viewProjection;
+}
+
+/***********************************************************
+ *  ResolveShaderHandles()
+ *
+ *  Resolves the view/projection uniform names once. Runs lazily
+ *  on the first frame, after the shader program is in use.
+ ***********************************************************/
+void ViewManager::ResolveShaderHandles()
+{
+	m_uniforms.AttachToActiveProgram();
+
+	m_hView = m_uniforms.Resolve(g_ViewName);
+	m_hProjection = m_uniforms.Resolve(g_ProjectionName);
+	m_hViewPosition = m_uniforms.Resolve("viewPosition");
+
+	m_bHandlesResolved = true;
 }
 
 /***********************************************************
@@ -271,6 +497,8 @@ void ViewManager::ProcessKeyboardEvents()
  ***********************************************************/
 void ViewManager::PrepareSceneView()
 {
+	GpuProfiler::Instance().BeginCpuSection("PrepareSceneView");
+
 	glm::mat4 view;
 	glm::mat4 projection;
 
@@ -282,6 +510,20 @@ void ViewManager::PrepareSceneView()
 	// process any keyboard events that may be waiting in the event queue
 	ProcessKeyboardEvents();
 
+	// Fixed-timestep camera simulation: consume the frame delta in
+	// constant 240 Hz steps, then interpolate between the last two
+	// simulated positions by the leftover fraction. The clamp keeps
+	// one long stall from triggering a burst of catch-up steps.
+	gSimAccumulator += (gDeltaTime < kMaxFrameDelta) ? gDeltaTime : kMaxFrameDelta;
+	while (gSimAccumulator >= kFixedTimestep)
+	{
+		gPrevSimPosition = g_pCamera->Position;
+		IntegrateCameraMovement(kFixedTimestep);
+		gSimAccumulator -= kFixedTimestep;
+	}
+	const float alpha = gSimAccumulator / kFixedTimestep;
+	gRenderPosition = glm::mix(gPrevSimPosition, g_pCamera->Position, alpha);
+
 	// Define view and projection matrices based on current mode
 	if (bOrthographicProjection)
 	{
@@ -301,8 +543,11 @@ void ViewManager::PrepareSceneView()
 	}
 	else
 	{
-		// Perspective: normal free-look camera
-		view = g_pCamera->GetViewMatrix();
+		// Perspective: free-look camera at the interpolated position
+		view = glm::lookAt(
+			gRenderPosition,
+			gRenderPosition + g_pCamera->Front,
+			g_pCamera->Up);
 
 		projection = glm::perspective(
 			glm::radians(g_pCamera->Zoom),
@@ -310,23 +555,34 @@ void ViewManager::PrepareSceneView()
 			0.1f, 100.0f);
 	}
 
+	// keep the combined matrix for the scene's frustum cull
+	m_viewProjection = projection * view;
+
 	// if the shader manager object is valid
 	if (NULL != m_pShaderManager)
 	{
+		// resolve the uniform names once, then upload via handles
+		if (!m_bHandlesResolved)
+		{
+			ResolveShaderHandles();
+		}
+
 		// set the view matrix into the shader for proper rendering
-		m_pShaderManager->setMat4Value(g_ViewName, view);
+		m_uniforms.SetMat4Value(m_hView, view);
 
 		// set the projection matrix into the shader for proper rendering
-		m_pShaderManager->setMat4Value(g_ProjectionName, projection);
+		m_uniforms.SetMat4Value(m_hProjection, projection);
 
 		// set the view position of the camera into the shader for proper rendering
 		if (bOrthographicProjection)
 		{
-			m_pShaderManager->setVec3Value("viewPosition", gOrthoCamPos);
+			m_uniforms.SetVec3Value(m_hViewPosition, gOrthoCamPos);
 		}
 		else
 		{
-			m_pShaderManager->setVec3Value("viewPosition", g_pCamera->Position);
+			m_uniforms.SetVec3Value(m_hViewPosition, gRenderPosition);
 		}
 	}
+
+	GpuProfiler::Instance().EndCpuSection();
 }
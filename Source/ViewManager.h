@@ -10,6 +10,7 @@
 #pragma once
 
 #include "ShaderManager.h"
+#include "UniformCache.h"
 #include "camera.h"
 
 // GLFW library
@@ -36,13 +37,48 @@ private:
 	// active OpenGL display window
 	GLFWwindow* m_pWindow;
 
+	// handle-based uniform upload path (names resolved on first frame)
+	UniformCache m_uniforms;
+	bool m_bHandlesResolved;
+	int m_hView;
+	int m_hProjection;
+	int m_hViewPosition;
+
+	// resolves the view/projection uniform names into handles
+	void ResolveShaderHandles();
+
+	// projection * view for the frame most recently prepared
+	glm::mat4 m_viewProjection;
+
 	// process keyboard events for interaction with the 3D scene
 	void ProcessKeyboardEvents();
 
+	// advances the camera by one fixed simulation step from the
+	// currently held movement keys (240 Hz accumulator, so camera
+	// velocity no longer depends on render frame time)
+	void IntegrateCameraMovement(float timestep);
+
 public:
 	// create the initial OpenGL display window
 	GLFWwindow* CreateDisplayWindow(const char* windowTitle);
 
 	// prepare the conversion from 3D object display to 2D scene display
 	void PrepareSceneView();
+
+	// drive the camera from a script (used by the benchmark harness);
+	// also keeps the mouse-look yaw/pitch consistent with the new pose
+	void SetCameraPose(glm::vec3 position, glm::vec3 front);
+
+	// the eye position used for the current frame (respects the
+	// orthographic inspection view); lets the scene do distance tests
+	glm::vec3 GetCameraPosition() const;
+
+	// combined projection * view matrix uploaded this frame; the
+	// scene extracts its culling frustum from it
+	glm::mat4 GetViewProjectionMatrix() const;
+
+	// on-demand rendering: returns true (and clears the flag) when
+	// camera movement, mouse look, or a projection toggle changed
+	// the view since the last call
+	bool ConsumeViewDirty();
 };